@@ -0,0 +1,284 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by LXQt team                                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileSystemWatcher>
+#include <QTemporaryDir>
+#include <QTimer>
+
+#include "commandrunner.h"
+#include "dbusaddressable.h"
+#include "mainwindow.h"
+#include "qterminalapp.h"
+#include "tabwidget.h"
+#include "terminalconfig.h"
+#include "termwidget.h"
+#include "termwidgetholder.h"
+
+// finished commands that commands() still reports
+static const int MAX_FINISHED = 64;
+
+/* Runs "$@" and writes its status to the file $1, renamed into place so
+   that the watcher never sees it half written. With $2 = "always" or
+   "failure" the shell $3 takes over the terminal afterwards. */
+static const char WRAPPER[] =
+    "status=$1 keep=$2 shell=$3; shift 3\n"
+    "\"$@\"\n"
+    "code=$?\n"
+    "echo \"$code\" > \"$status.part\" && mv -f \"$status.part\" \"$status\"\n"
+    "if [ \"$keep\" = always ] || { [ \"$keep\" = failure ] && [ \"$code\" -ne 0 ]; }; then\n"
+    "    printf '\\n[%s exited with status %d]\\n' \"$1\" \"$code\"\n"
+    "    exec \"$shell\"\n"
+    "fi\n"
+    "exit \"$code\"\n";
+
+// object paths arrive as such over D-Bus and as strings otherwise
+static QString pathOption(const QVariant &value)
+{
+    if (value.userType() == qMetaTypeId<QDBusObjectPath>())
+        return value.value<QDBusObjectPath>().path();
+    return value.toString();
+}
+
+CommandRunner::CommandRunner(QObject *parent)
+    : QObject(parent)
+    , m_lastId(0)
+    , m_watcher(nullptr)
+{
+}
+
+CommandRunner::~CommandRunner() = default;
+
+int CommandRunner::run(const QStringList &command, const QVariantMap &options)
+{
+    if (command.isEmpty())
+        return -1;
+
+    if (m_dir == nullptr)
+    {
+        m_dir = std::make_unique<QTemporaryDir>(QDir::tempPath() + QStringLiteral("/qterminal-commands-XXXXXX"));
+        if (!m_dir->isValid())
+        {
+            qWarning() << "Cannot create a directory for the exit status of commands:" << m_dir->errorString();
+            m_dir.reset();
+            return -1;
+        }
+        m_watcher = new QFileSystemWatcher(QStringList{m_dir->path()}, this);
+        connect(m_watcher, &QFileSystemWatcher::directoryChanged, this, &CommandRunner::checkStatus);
+    }
+
+    Job job;
+    job.id = ++m_lastId;
+    job.command = command;
+    job.options = fromDbusVariant(options).toMap();
+    job.queue = job.options.value(QStringLiteral("queue")).toString();
+    if (job.options.contains(QStringLiteral("maxConcurrent")))
+        m_limits[job.queue] = qMax(0, job.options.value(QStringLiteral("maxConcurrent")).toInt());
+    m_jobs.append(job);
+
+    schedule();
+    return job.id;
+}
+
+QVariantList CommandRunner::commands() const
+{
+    static const char *const states[] = {"queued", "running", "finished"};
+    QVariantList list;
+    for (const Job &job : m_jobs)
+    {
+        QVariantMap info;
+        info[QStringLiteral("id")] = job.id;
+        info[QStringLiteral("command")] = job.command;
+        info[QStringLiteral("queue")] = job.queue;
+        info[QStringLiteral("state")] = QLatin1String(states[job.state]);
+        if (job.state != Queued)
+        {
+            info[QStringLiteral("terminal")] = QVariant::fromValue(job.terminalPath);
+            info[QStringLiteral("runtime")] = job.state == Running ? job.clock.elapsed() : job.runtime;
+        }
+        if (job.state == Finished)
+            info[QStringLiteral("exitStatus")] = job.exitStatus;
+        list.append(info);
+    }
+    return list;
+}
+
+void CommandRunner::schedule()
+{
+    QHash<QString, int> running;
+    int finished = 0;
+    for (const Job &job : std::as_const(m_jobs))
+    {
+        if (job.state == Running)
+            ++running[job.queue];
+        else if (job.state == Finished)
+            ++finished;
+    }
+    // the oldest finished ones are forgotten
+    for (int i = 0; i < m_jobs.size() && finished > MAX_FINISHED; )
+    {
+        if (m_jobs.at(i).state == Finished)
+        {
+            m_jobs.removeAt(i);
+            --finished;
+        }
+        else
+            ++i;
+    }
+
+    for (int i = 0; i < m_jobs.size(); ++i)
+    {
+        Job &job = m_jobs[i];
+        if (job.state != Queued)
+            continue;
+        const int limit = m_limits.value(job.queue, 0);
+        if (limit > 0 && running.value(job.queue) >= limit)
+            continue;
+        ++running[job.queue];
+        start(job);
+    }
+}
+
+void CommandRunner::start(Job &job)
+{
+    job.state = Running;
+    job.clock.start();
+    TermWidget *term = openTerminal(job);
+    if (term == nullptr)
+    {
+        // no window to open it in, e.g. while quitting
+        finish(job.id, -1);
+        return;
+    }
+    job.terminal = term;
+    job.terminalPath = term->getDbusPath();
+
+    const int id = job.id;
+    connect(term, &QObject::destroyed, this, [this, id] {
+        for (const Job &job : std::as_const(m_jobs))
+        {
+            if (job.id != id || job.state != Running)
+                continue;
+            // the status may be written just before the shell exits
+            int status;
+            finish(id, readStatus(job, status) ? status : -1);
+            return;
+        }
+    });
+    emit started(id, job.terminalPath);
+}
+
+TermWidget *CommandRunner::openTerminal(const Job &job)
+{
+    QHash<QString,QVariant> termArgs;
+    for (const char *key : {"workingDirectory", "title"})
+    {
+        const QString name = QLatin1String(key);
+        if (job.options.contains(name))
+            termArgs[name] = job.options.value(name).toString();
+    }
+    const QString keepOpen = job.options.value(QStringLiteral("keepOpen"), QStringLiteral("never")).toString();
+    const QString shell = TerminalConfig().getShell().value(0, QStringLiteral("/bin/sh"));
+    termArgs[QStringLiteral("shell")] = QStringList{QStringLiteral("/bin/sh"), QStringLiteral("-c"),
+                                                    QLatin1String(WRAPPER), QStringLiteral("qterminal-command"),
+                                                    statusFile(job.id), keepOpen, shell} + job.command;
+
+    TermWidget *target = nullptr;
+    if (job.options.contains(QStringLiteral("split")))
+        target = findDbusObject<TermWidget>(QDBusObjectPath(pathOption(job.options.value(QStringLiteral("split")))));
+    if (target != nullptr)
+    {
+        TermWidgetHolder *holder = findParent<TermWidgetHolder>(target);
+        if (holder == nullptr)
+            return nullptr;
+        const Qt::Orientation orientation = job.options.value(QStringLiteral("orientation")).toString() == QLatin1String("vertical")
+                                            ? Qt::Vertical : Qt::Horizontal;
+        TerminalConfig cfg = TerminalConfig::fromDbus(termArgs, target);
+        return holder->split(target, orientation, cfg);
+    }
+
+    // a terminal to split that is gone by now is replaced with a tab
+    QTerminalApp *app = QTerminalApp::Instance();
+    MainWindow *window = nullptr;
+    if (job.options.contains(QStringLiteral("window")))
+        window = findDbusObject<MainWindow>(QDBusObjectPath(pathOption(job.options.value(QStringLiteral("window")))));
+    if (window == nullptr)
+        window = qobject_cast<MainWindow*>(app->activeWindow());
+    if (window == nullptr && !app->getWindowList().isEmpty())
+        window = app->getWindowList().constFirst();
+
+    TerminalConfig cfg = TerminalConfig::fromDbus(termArgs);
+    TermWidgetHolder *holder = nullptr;
+    if (window == nullptr)
+    {
+        window = app->newWindow(false, cfg);
+        holder = qobject_cast<TermWidgetHolder*>(window->tabWidget()->currentWidget());
+    }
+    else
+    {
+        const int index = window->tabWidget()->addNewTab(cfg);
+        holder = qobject_cast<TermWidgetHolder*>(window->tabWidget()->widget(index));
+    }
+    return holder != nullptr ? holder->terminals().value(0) : nullptr;
+}
+
+void CommandRunner::checkStatus()
+{
+    QList<QPair<int, int>> ended;
+    for (const Job &job : std::as_const(m_jobs))
+    {
+        int status;
+        if (job.state == Running && readStatus(job, status))
+            ended.append({job.id, status});
+    }
+    for (const auto &end : std::as_const(ended))
+        finish(end.first, end.second);
+}
+
+bool CommandRunner::readStatus(const Job &job, int &status) const
+{
+    QFile file(statusFile(job.id));
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+    bool ok = false;
+    status = file.readAll().trimmed().toInt(&ok);
+    return ok;
+}
+
+void CommandRunner::finish(int id, int status)
+{
+    for (Job &job : m_jobs)
+    {
+        if (job.id != id || job.state != Running)
+            continue;
+        job.state = Finished;
+        job.exitStatus = status;
+        job.runtime = job.clock.elapsed();
+        QFile::remove(statusFile(id));
+        emit finished(id, status, job.runtime);
+        break;
+    }
+    // not from within the destruction of a terminal
+    QTimer::singleShot(0, this, &CommandRunner::schedule);
+}
+
+QString CommandRunner::statusFile(int id) const
+{
+    return m_dir->filePath(QString::number(id));
+}
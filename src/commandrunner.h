@@ -0,0 +1,109 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by LXQt team                                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#ifndef COMMANDRUNNER_H
+#define COMMANDRUNNER_H
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QPointer>
+#include <QStringList>
+#include <QVariantMap>
+#include <QtDBus/QDBusObjectPath>
+
+#include <memory>
+
+class QFileSystemWatcher;
+class QTemporaryDir;
+class TermWidget;
+
+/*! \brief Commands run in terminals of their own, reporting how they ended.
+
+Every command gets a new tab, or splits a terminal, and runs under a small
+shell wrapper that writes its exit status to a file of a private directory
+before the terminal closes. A QFileSystemWatcher on the directory tells
+when a command is over, so nothing is polled, and the status is known even
+when the terminal stays open afterwards.
+
+Options of run():
+    "window"            o   the window for the new tab, else the active one
+    "split"             o   a terminal to split instead of opening a tab
+    "orientation"       s   "horizontal" (default) or "vertical", for "split"
+    "workingDirectory"  s
+    "title"             s
+    "keepOpen"          s   "never" (default), "failure" or "always": an
+                            interactive shell is started in the terminal
+                            when the command is over
+    "queue"             s   commands of a queue share its limit
+    "maxConcurrent"     i   sets the limit of the queue, 0 for none; the
+                            others wait and start as running ones end
+
+The exit status is that of the shell, 128 + n for signal n, and -1 when
+the terminal was closed before the command was over.
+*/
+class CommandRunner : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit CommandRunner(QObject *parent = nullptr);
+    ~CommandRunner() override;
+
+    // the id of the command, -1 if \a command is empty
+    int run(const QStringList &command, const QVariantMap &options);
+    // the queued, running and recently finished commands
+    QVariantList commands() const;
+
+signals:
+    void started(int id, const QDBusObjectPath &terminal);
+    void finished(int id, int exitStatus, qint64 runtime);
+
+private:
+    enum State { Queued, Running, Finished };
+
+    struct Job {
+        int id;
+        QStringList command;
+        QVariantMap options;
+        QString queue;
+        State state = Queued;
+        QPointer<TermWidget> terminal;
+        QDBusObjectPath terminalPath;
+        QElapsedTimer clock;
+        qint64 runtime = 0;
+        int exitStatus = -1;
+    };
+
+    void schedule();
+    void start(Job &job);
+    TermWidget *openTerminal(const Job &job);
+    void checkStatus();
+    // reads the status file of a running job, false if there is none yet
+    bool readStatus(const Job &job, int &status) const;
+    void finish(int id, int status);
+    QString statusFile(int id) const;
+
+    QList<Job> m_jobs;
+    QHash<QString, int> m_limits;
+    int m_lastId;
+    std::unique_ptr<QTemporaryDir> m_dir;
+    QFileSystemWatcher *m_watcher;
+};
+
+#endif
@@ -24,6 +24,8 @@
 #define RENAME_TAB "Rename Tab"
 #define CLOSE_TAB "Close Tab"
 #define NEW_WINDOW "New Window"
+#define SAVE_SESSION "Save Session"
+#define LOAD_SESSION "Load Session"
 
 #define QUIT "Quit"
 #define PREFERENCES "Preferences..."
@@ -32,6 +34,7 @@
 #define TAB_NEXT_HISTORY "Next Tab in History"
 #define TAB_NEXT "Next Tab"
 #define TAB_PREV "Previous Tab"
+#define FIND_TAB "Find Tab"
 
 #define CLEAR_TERMINAL "Clear Active Terminal"
 
@@ -39,6 +42,13 @@
 #define SPLIT_VERTICAL "Split View Left-Right"
 
 #define SUB_COLLAPSE "Collapse Subterminal"
+#define SUB_MAXIMIZE "Maximize Subterminal"
+#define SUB_TO_NEW_TAB "Move Subterminal to New Tab"
+#define BROADCAST_OFF "Broadcast Off"
+#define BROADCAST_TAB "Broadcast To Tab"
+#define BROADCAST_ALL_TABS "Broadcast To All Tabs"
+#define BROADCAST_SELECTION "Broadcast To Selection"
+#define BROADCAST_TOGGLE_TERMINAL "Toggle Terminal In Broadcast"
 #define SUB_LEFT "Left Subterminal"
 #define SUB_RIGHT "Right Subterminal"
 #define SUB_TOP "Top Subterminal"
@@ -46,6 +56,7 @@
 
 #define MOVE_LEFT "Move Tab Left"
 #define MOVE_RIGHT "Move Tab Right"
+#define TAB_TO_NEW_WINDOW "Move Tab to New Window"
 
 #define COPY_SELECTION "Copy Selection"
 #define PASTE_CLIPBOARD "Paste Clipboard"
@@ -56,6 +67,7 @@
 #define ZOOM_RESET "Zoom reset"
 
 #define FIND "Find"
+#define FIND_ALL "Find in All Terminals"
 
 #define TOGGLE_MENU "Toggle Menu"
 #define TOGGLE_BOOKMARKS "Toggle Bookmarks"
@@ -0,0 +1,338 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by LXQt team                                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QPointer>
+#include <QSocketNotifier>
+#include <QtDBus/QDBusObjectPath>
+#include <QtDBus/QDBusUnixFileDescriptor>
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "controlprotocol.h"
+
+static const int CONTROL_READ_SIZE = 64 * 1024;
+static const int CONTROL_MAX_FDS = 16;
+// a client that never ends its line must not fill the memory
+static const int CONTROL_MAX_LINE = 16 * 1024 * 1024;
+
+static void closeAll(const QList<int> &fds)
+{
+    for (const int fd : fds)
+        ::close(fd);
+}
+
+ControlChannel::ControlChannel(int fd, QObject *parent)
+    : QObject(parent)
+    , m_fd(fd)
+    , m_readNotifier(new QSocketNotifier(fd, QSocketNotifier::Read, this))
+    , m_writeNotifier(new QSocketNotifier(fd, QSocketNotifier::Write, this))
+    , m_eof(false)
+    , m_dispatching(false)
+    , m_pendingReplies(0)
+{
+    m_writeNotifier->setEnabled(false);
+    connect(m_readNotifier, &QSocketNotifier::activated, this, &ControlChannel::readLines);
+    connect(m_writeNotifier, &QSocketNotifier::activated, this, &ControlChannel::flush);
+}
+
+ControlChannel::~ControlChannel()
+{
+    close();
+}
+
+QList<int> ControlChannel::takeFds(int count)
+{
+    if (count <= 0 || count > m_fds.size())
+        return QList<int>();
+    const QList<int> fds = m_fds.mid(0, count);
+    m_fds.remove(0, count);
+    return fds;
+}
+
+void ControlChannel::readLines()
+{
+    char buffer[CONTROL_READ_SIZE];
+    alignas(cmsghdr) char control[CMSG_SPACE(CONTROL_MAX_FDS * sizeof(int))];
+    while (m_fd >= 0 && !m_eof)
+    {
+        iovec iov = {buffer, sizeof(buffer)};
+        msghdr msg = {};
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof(control);
+
+        const ssize_t count = ::recvmsg(m_fd, &msg, MSG_DONTWAIT | MSG_CMSG_CLOEXEC);
+        if (count < 0 && errno == EINTR)
+            continue;
+        if (count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            break;
+        if (count < 0)
+        {
+            close();
+            return;
+        }
+
+        for (cmsghdr *c = CMSG_FIRSTHDR(&msg); c != nullptr; c = CMSG_NXTHDR(&msg, c))
+        {
+            if (c->cmsg_level != SOL_SOCKET || c->cmsg_type != SCM_RIGHTS)
+                continue;
+            const int n = static_cast<int>((c->cmsg_len - CMSG_LEN(0)) / sizeof(int));
+            const int *received = reinterpret_cast<const int*>(CMSG_DATA(c));
+            for (int i = 0; i < n; ++i)
+                m_fds.append(received[i]);
+        }
+        if (count == 0)
+        {
+            // the peer is done sending, but may still wait for the replies
+            m_eof = true;
+            m_readNotifier->setEnabled(false);
+            // the last line needs no newline
+            if (!m_input.isEmpty() && !m_input.endsWith('\n'))
+                m_input.append('\n');
+            break;
+        }
+        m_input.append(buffer, count);
+    }
+
+    if (m_input.size() > CONTROL_MAX_LINE && !m_input.contains('\n'))
+    {
+        close();
+        return;
+    }
+    dispatch();
+}
+
+void ControlChannel::dispatch()
+{
+    // a nested event loop of a handler may read more, which is left to
+    // the outer loop here
+    if (m_dispatching)
+        return;
+    m_dispatching = true;
+    QPointer<ControlChannel> self(this);
+    qsizetype end;
+    while (m_fd >= 0 && (end = m_input.indexOf('\n')) != -1)
+    {
+        const QByteArray line = m_input.left(end);
+        m_input.remove(0, end + 1);
+        emit lineReceived(line);
+        if (self.isNull())
+            return;
+    }
+    m_dispatching = false;
+    closeWhenDone();
+}
+
+void ControlChannel::send(const QByteArray &line, const QList<int> &fds)
+{
+    if (m_fd < 0)
+    {
+        closeAll(fds);
+        return;
+    }
+    m_output.append({line, fds});
+    flush();
+}
+
+void ControlChannel::beginReply()
+{
+    ++m_pendingReplies;
+}
+
+void ControlChannel::endReply()
+{
+    if (m_pendingReplies > 0)
+        --m_pendingReplies;
+    closeWhenDone();
+}
+
+void ControlChannel::flush()
+{
+    while (m_fd >= 0 && !m_output.isEmpty())
+    {
+        Outgoing &out = m_output.first();
+        iovec iov = {out.data.data(), static_cast<size_t>(out.data.size())};
+        msghdr msg = {};
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+        alignas(cmsghdr) char control[CMSG_SPACE(CONTROL_MAX_FDS * sizeof(int))];
+        if (!out.fds.isEmpty())
+        {
+            const int n = qMin(static_cast<int>(out.fds.size()), CONTROL_MAX_FDS);
+            msg.msg_control = control;
+            msg.msg_controllen = CMSG_SPACE(n * sizeof(int));
+            cmsghdr *c = CMSG_FIRSTHDR(&msg);
+            c->cmsg_level = SOL_SOCKET;
+            c->cmsg_type = SCM_RIGHTS;
+            c->cmsg_len = CMSG_LEN(n * sizeof(int));
+            std::memcpy(CMSG_DATA(c), out.fds.constData(), n * sizeof(int));
+        }
+
+        const ssize_t sent = ::sendmsg(m_fd, &msg, MSG_DONTWAIT | MSG_NOSIGNAL);
+        if (sent < 0 && errno == EINTR)
+            continue;
+        if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            break;
+        if (sent < 0)
+        {
+            close();
+            return;
+        }
+        // the descriptors went with the first byte
+        closeAll(out.fds);
+        out.fds.clear();
+        if (sent < out.data.size())
+        {
+            out.data.remove(0, sent);
+            break;
+        }
+        m_output.removeFirst();
+    }
+    if (m_fd >= 0)
+        m_writeNotifier->setEnabled(!m_output.isEmpty());
+    closeWhenDone();
+}
+
+void ControlChannel::closeWhenDone()
+{
+    if (m_eof && !m_dispatching && m_output.isEmpty() && m_pendingReplies == 0)
+        close();
+}
+
+void ControlChannel::close()
+{
+    if (m_fd < 0)
+        return;
+    // the notifiers must not watch a closed descriptor
+    m_readNotifier->setEnabled(false);
+    m_writeNotifier->setEnabled(false);
+    ::close(m_fd);
+    m_fd = -1;
+    closeAll(m_fds);
+    m_fds.clear();
+    for (const Outgoing &out : std::as_const(m_output))
+        closeAll(out.fds);
+    m_output.clear();
+    m_input.clear();
+    emit closed();
+}
+
+// ---------------------------------------------------------------------------
+
+int maxFdIndex(const QJsonValue &value)
+{
+    int result = -1;
+    if (value.isArray())
+    {
+        const QJsonArray array = value.toArray();
+        for (const QJsonValue &item : array)
+            result = qMax(result, maxFdIndex(item));
+    }
+    else if (value.isObject())
+    {
+        const QJsonObject object = value.toObject();
+        if (object.size() == 1 && object.value(QLatin1String("fd")).isDouble())
+            return object.value(QLatin1String("fd")).toInt();
+        for (auto it = object.constBegin(); it != object.constEnd(); ++it)
+            result = qMax(result, maxFdIndex(it.value()));
+    }
+    return result;
+}
+
+bool fromJson(const QJsonValue &value, QMetaType type, const QList<int> &fds, QVariant &result)
+{
+    const int id = type.id();
+    if (id == QMetaType::QString && value.isString())
+        result = value.toString();
+    else if (id == QMetaType::Int && value.isDouble())
+        result = value.toInt();
+    else if (id == QMetaType::Bool && value.isBool())
+        result = value.toBool();
+    else if (id == QMetaType::QByteArray && value.isString())
+        result = QByteArray::fromBase64(value.toString().toLatin1());
+    else if (id == QMetaType::QStringList && value.isArray())
+        result = value.toVariant().toStringList();
+    else if (id == QMetaType::QVariantMap && value.isObject())
+        result = value.toObject().toVariantMap();
+    else if (id == QMetaType::QVariantHash && value.isObject())
+        result = value.toObject().toVariantHash();
+    else if (id == qMetaTypeId<QDBusObjectPath>() && value.isString())
+        result = QVariant::fromValue(QDBusObjectPath(value.toString()));
+    else if (id == qMetaTypeId<QDBusUnixFileDescriptor>() && value.isObject())
+    {
+        const int index = value.toObject().value(QLatin1String("fd")).toInt(-1);
+        if (index < 0 || index >= fds.size())
+            return false;
+        // takes a copy
+        result = QVariant::fromValue(QDBusUnixFileDescriptor(fds.at(index)));
+    }
+    else
+    {
+        result = value.toVariant();
+        return result.convert(type);
+    }
+    return true;
+}
+
+QJsonValue toJson(const QVariant &value, QList<int> &fds)
+{
+    const int id = value.userType();
+    if (id == qMetaTypeId<QDBusObjectPath>())
+        return value.value<QDBusObjectPath>().path();
+    if (id == qMetaTypeId<QList<QDBusObjectPath>>())
+    {
+        QJsonArray array;
+        const auto paths = value.value<QList<QDBusObjectPath>>();
+        for (const QDBusObjectPath &path : paths)
+            array.append(path.path());
+        return array;
+    }
+    if (id == qMetaTypeId<QDBusUnixFileDescriptor>())
+    {
+        const QDBusUnixFileDescriptor fd = value.value<QDBusUnixFileDescriptor>();
+        if (!fd.isValid())
+            return QJsonValue();
+        fds.append(::fcntl(fd.fileDescriptor(), F_DUPFD_CLOEXEC, 0));
+        return QJsonObject{{QStringLiteral("fd"), int(fds.size() - 1)}};
+    }
+    if (id == QMetaType::QByteArray)
+        return QString::fromLatin1(value.toByteArray().toBase64());
+    if (id == QMetaType::QVariantMap)
+    {
+        QJsonObject object;
+        const QVariantMap map = value.toMap();
+        for (auto it = map.constBegin(); it != map.constEnd(); ++it)
+            object.insert(it.key(), toJson(it.value(), fds));
+        return object;
+    }
+    if (id == QMetaType::QVariantList)
+    {
+        QJsonArray array;
+        const QVariantList list = value.toList();
+        for (const QVariant &item : list)
+            array.append(toJson(item, fds));
+        return array;
+    }
+    return QJsonValue::fromVariant(value);
+}
@@ -0,0 +1,106 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by LXQt team                                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#ifndef CONTROLPROTOCOL_H
+#define CONTROLPROTOCOL_H
+
+#include <QByteArray>
+#include <QJsonValue>
+#include <QList>
+#include <QMetaType>
+#include <QObject>
+#include <QVariant>
+
+class QSocketNotifier;
+
+/*! \brief The framing of the control socket, see ControlServer.
+
+Reads lines from a Unix stream socket along with the file descriptors
+sent as SCM_RIGHTS, and writes lines, each with the descriptors that go
+with it. Every complete line is taken out of the input before
+lineReceived() is emitted, so a handler that runs a nested event loop
+cannot see it twice.
+
+When the peer has finished sending, the lines already received are still
+delivered, and the channel closes once all replies are written and none
+is pending, see beginReply().
+*/
+class ControlChannel : public QObject
+{
+    Q_OBJECT
+
+public:
+    // takes over \a fd, a connected stream socket
+    explicit ControlChannel(int fd, QObject *parent = nullptr);
+    ~ControlChannel() override;
+
+    bool isOpen() const { return m_fd >= 0; }
+
+    // the next \a count descriptors received, or none if fewer arrived
+    QList<int> takeFds(int count);
+
+    // the descriptors are sent with the first byte of \a line, then closed
+    void send(const QByteArray &line, const QList<int> &fds = QList<int>());
+
+    // keeps the channel open for a reply that is sent later
+    void beginReply();
+    void endReply();
+
+signals:
+    void lineReceived(const QByteArray &line);
+    void closed();
+
+private:
+    struct Outgoing {
+        QByteArray data;
+        QList<int> fds;
+    };
+
+    void readLines();
+    void dispatch();
+    void flush();
+    void closeWhenDone();
+    void close();
+
+    int m_fd;
+    QSocketNotifier *m_readNotifier;
+    QSocketNotifier *m_writeNotifier;
+    QByteArray m_input;
+    // received, taken in order by the requests that use them
+    QList<int> m_fds;
+    QList<Outgoing> m_output;
+    bool m_eof;
+    bool m_dispatching;
+    int m_pendingReplies;
+};
+
+// the highest index of {"fd": i} in a JSON value, -1 if there is none
+int maxFdIndex(const QJsonValue &value);
+
+/*! Converts a JSON parameter to \a type, the type of a D-Bus adaptor
+    argument. Object paths are strings, byte arrays base64 and file
+    descriptors {"fd": i}, an index into \a fds. Returns false if the
+    value does not fit.
+ */
+bool fromJson(const QJsonValue &value, QMetaType type, const QList<int> &fds, QVariant &result);
+
+/*! The reverse of fromJson(), for results. The descriptors are duplicated
+    and appended to \a fds, which the caller sends and closes.
+ */
+QJsonValue toJson(const QVariant &value, QList<int> &fds);
+
+#endif
@@ -0,0 +1,315 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by LXQt team                                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include <QDBusAbstractAdaptor>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMetaMethod>
+#include <QPointer>
+#include <QSocketNotifier>
+#include <QtDBus/QtDBus>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "controlprotocol.h"
+#include "controlsocket.h"
+#include "dbusaddressable.h"
+#include "qterminalapp.h"
+#include "termwidget.h"
+
+// JSON-RPC 2.0 error codes
+static const int PARSE_ERROR = -32700;
+static const int INVALID_REQUEST = -32600;
+static const int METHOD_NOT_FOUND = -32601;
+static const int INVALID_PARAMS = -32602;
+static const int NO_SUCH_OBJECT = -32000;
+
+// ---------------------------------------------------------------------------
+
+class ControlConnection : public QObject
+{
+public:
+    ControlConnection(int fd, QObject *parent);
+
+    void reply(const QJsonValue &id, const QJsonValue &result, const QList<int> &fds = QList<int>());
+    void replyError(const QJsonValue &id, int code, const QString &message);
+
+private:
+    void handle(const QByteArray &line);
+    void call(QObject *target, const QString &method, const QJsonArray &params, const QJsonValue &id);
+
+    ControlChannel *m_channel;
+};
+
+static void closeAll(const QList<int> &fds)
+{
+    for (const int fd : fds)
+        ::close(fd);
+}
+
+ControlConnection::ControlConnection(int fd, QObject *parent)
+    : QObject(parent)
+    , m_channel(new ControlChannel(fd, this))
+{
+    connect(m_channel, &ControlChannel::lineReceived, this, [this](const QByteArray &line) { handle(line); });
+    connect(m_channel, &ControlChannel::closed, this, &QObject::deleteLater);
+}
+
+void ControlConnection::handle(const QByteArray &line)
+{
+    if (line.trimmed().isEmpty())
+        return;
+
+    QJsonParseError parseError;
+    const QJsonDocument doc = QJsonDocument::fromJson(line, &parseError);
+    if (!doc.isObject())
+    {
+        replyError(QJsonValue(QJsonValue::Null), PARSE_ERROR, parseError.errorString());
+        return;
+    }
+    const QJsonObject request = doc.object();
+    const QJsonValue id = request.value(QLatin1String("id"));
+    const QString method = request.value(QLatin1String("method")).toString();
+    const QJsonValue params = request.value(QLatin1String("params"));
+    if (method.isEmpty() || !(params.isArray() || params.isUndefined()))
+    {
+        replyError(id, INVALID_REQUEST, QStringLiteral("a request needs a method and an array of params"));
+        return;
+    }
+
+    const QString path = request.value(QLatin1String("path")).toString(QStringLiteral("/"));
+    QObject *target = nullptr;
+    if (path == QLatin1String("/"))
+        target = QTerminalApp::Instance();
+    else
+        target = dynamic_cast<QObject*>(DBusAddressable::lookup(path));
+    if (target == nullptr)
+    {
+        replyError(id, NO_SUCH_OBJECT, QStringLiteral("no object at %1").arg(path));
+        return;
+    }
+    call(target, method, params.toArray(), id);
+}
+
+void ControlConnection::call(QObject *target, const QString &method, const QJsonArray &params, const QJsonValue &id)
+{
+    // the descriptors sent along with this request
+    QList<int> fds;
+    const int fdCount = maxFdIndex(params) + 1;
+    if (fdCount > 0 && (fds = m_channel->takeFds(fdCount)).isEmpty())
+    {
+        replyError(id, INVALID_PARAMS, QStringLiteral("%1 file descriptors expected").arg(fdCount));
+        return;
+    }
+
+    // its reply is delayed, which only D-Bus messages can be otherwise
+    TermWidget *term = qobject_cast<TermWidget*>(target);
+    if (term != nullptr && method == QLatin1String("waitFor") && params.size() == 2)
+    {
+        closeAll(fds);
+        QPointer<ControlConnection> self(this);
+        QString error;
+        m_channel->beginReply();
+        if (!term->waitForOutput(params.at(0).toString(), params.at(1).toInt(), [self, id](bool matched, const QString &text) {
+                if (self)
+                {
+                    self->reply(id, QJsonArray{matched, text});
+                    self->m_channel->endReply();
+                }
+            }, &error))
+        {
+            replyError(id, INVALID_PARAMS, error);
+            m_channel->endReply();
+        }
+        return;
+    }
+
+    QDBusAbstractAdaptor *adaptor = target->findChild<QDBusAbstractAdaptor*>(QString(), Qt::FindDirectChildrenOnly);
+    const QMetaObject *meta = adaptor != nullptr ? adaptor->metaObject() : nullptr;
+    QMetaMethod slot;
+    for (int i = meta != nullptr ? meta->methodOffset() : 0; meta != nullptr && i < meta->methodCount(); ++i)
+    {
+        const QMetaMethod m = meta->method(i);
+        if (m.methodType() != QMetaMethod::Slot || m.name() != method.toLatin1()
+            || m.parameterCount() != params.size())
+            continue;
+        // out arguments besides the result need a D-Bus message to reply to
+        const QList<QByteArray> types = m.parameterTypes();
+        if (std::none_of(types.cbegin(), types.cend(), [](const QByteArray &type) { return type.endsWith('&'); }))
+        {
+            slot = m;
+            break;
+        }
+    }
+    if (!slot.isValid())
+    {
+        closeAll(fds);
+        replyError(id, METHOD_NOT_FOUND, QStringLiteral("no method %1 with %2 parameters").arg(method).arg(params.size()));
+        return;
+    }
+
+    QVariantList args;
+    for (int i = 0; i < params.size(); ++i)
+    {
+        QVariant arg;
+        if (!fromJson(params.at(i), slot.parameterMetaType(i), fds, arg))
+        {
+            closeAll(fds);
+            replyError(id, INVALID_PARAMS, QStringLiteral("parameter %1 is not a %2").arg(i).arg(QLatin1String(slot.parameterMetaType(i).name())));
+            return;
+        }
+        args.append(arg);
+    }
+
+    QGenericArgument generic[10];
+    for (int i = 0; i < args.size(); ++i)
+        generic[i] = QGenericArgument(args.at(i).metaType().name(), args.at(i).constData());
+    QVariant result;
+    if (slot.returnMetaType().id() != QMetaType::Void)
+        result = QVariant(slot.returnMetaType());
+    const QGenericReturnArgument ret = result.isValid() ? QGenericReturnArgument(slot.returnMetaType().name(), result.data())
+                                                        : QGenericReturnArgument();
+    const bool invoked = slot.invoke(adaptor, Qt::DirectConnection, ret,
+                                     generic[0], generic[1], generic[2], generic[3], generic[4],
+                                     generic[5], generic[6], generic[7], generic[8], generic[9]);
+    // the called method made its own copies
+    closeAll(fds);
+    if (!invoked)
+    {
+        replyError(id, METHOD_NOT_FOUND, QStringLiteral("%1 could not be called").arg(method));
+        return;
+    }
+
+    QList<int> outFds;
+    const QJsonValue json = result.isValid() ? toJson(result, outFds) : QJsonValue();
+    reply(id, json, outFds);
+}
+
+void ControlConnection::reply(const QJsonValue &id, const QJsonValue &result, const QList<int> &fds)
+{
+    // a notification gets no reply
+    if (id.isUndefined() || id.isNull())
+    {
+        closeAll(fds);
+        return;
+    }
+    QJsonObject response{{QStringLiteral("jsonrpc"), QStringLiteral("2.0")},
+                         {QStringLiteral("id"), id},
+                         {QStringLiteral("result"), result}};
+    m_channel->send(QJsonDocument(response).toJson(QJsonDocument::Compact) + '\n', fds);
+}
+
+void ControlConnection::replyError(const QJsonValue &id, int code, const QString &message)
+{
+    if (id.isUndefined())
+        return;
+    QJsonObject response{{QStringLiteral("jsonrpc"), QStringLiteral("2.0")},
+                         {QStringLiteral("id"), id},
+                         {QStringLiteral("error"), QJsonObject{{QStringLiteral("code"), code},
+                                                               {QStringLiteral("message"), message}}}};
+    m_channel->send(QJsonDocument(response).toJson(QJsonDocument::Compact) + '\n');
+}
+
+// ---------------------------------------------------------------------------
+
+ControlServer::ControlServer(QObject *parent)
+    : QObject(parent)
+    , m_fd(-1)
+    , m_notifier(nullptr)
+{
+}
+
+ControlServer::~ControlServer()
+{
+    if (m_fd < 0)
+        return;
+    delete m_notifier;
+    ::close(m_fd);
+    QFile::remove(m_path);
+}
+
+bool ControlServer::listen(const QString &path)
+{
+    const QByteArray name = QFile::encodeName(path);
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if (name.isEmpty() || name.size() >= static_cast<qsizetype>(sizeof(address.sun_path)))
+    {
+        m_error = QStringLiteral("invalid socket path");
+        return false;
+    }
+    std::memcpy(address.sun_path, name.constData(), name.size());
+
+    const int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC | SOCK_NONBLOCK, 0);
+    if (fd < 0)
+    {
+        m_error = QString::fromLocal8Bit(std::strerror(errno));
+        return false;
+    }
+    // a socket left behind by an instance that is gone is replaced; the
+    // probe must not be the socket to bind
+    struct stat info;
+    if (::lstat(name.constData(), &info) == 0 && S_ISSOCK(info.st_mode))
+    {
+        const int probe = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (probe >= 0)
+        {
+            if (::connect(probe, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 && errno == ECONNREFUSED)
+                ::unlink(name.constData());
+            ::close(probe);
+        }
+    }
+    // only the user may control the terminals
+    const mode_t mask = ::umask(0077);
+    const bool bound = ::bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0;
+    ::umask(mask);
+    if (!bound || ::listen(fd, SOMAXCONN) != 0)
+    {
+        m_error = QString::fromLocal8Bit(std::strerror(errno));
+        ::close(fd);
+        return false;
+    }
+
+    m_fd = fd;
+    m_path = path;
+    m_notifier = new QSocketNotifier(fd, QSocketNotifier::Read, this);
+    connect(m_notifier, &QSocketNotifier::activated, this, &ControlServer::acceptConnection);
+    return true;
+}
+
+void ControlServer::acceptConnection()
+{
+    for (;;)
+    {
+        const int client = ::accept4(m_fd, nullptr, nullptr, SOCK_CLOEXEC | SOCK_NONBLOCK);
+        if (client < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            return;
+        }
+        new ControlConnection(client, this);
+    }
+}
@@ -0,0 +1,66 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by LXQt team                                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#ifndef CONTROLSOCKET_H
+#define CONTROLSOCKET_H
+
+#include <QObject>
+#include <QString>
+
+class QSocketNotifier;
+
+/*! \brief Remote control through a Unix domain socket.
+
+For hosts without a session bus, and for scripts that need short round
+trips. Every connection reads requests, one JSON object per line:
+
+    {"id": 1, "path": "/terminals/3", "method": "sendText", "params": ["ls\n"]}
+
+The paths, methods and parameters are those of the D-Bus interfaces; the
+path defaults to "/", the process. Each request with an id gets a reply
+line as in JSON-RPC 2.0, {"id": 1, "result": ...} or
+{"id": 1, "error": {"code": c, "message": s}}. Several out arguments come
+as an array.
+
+Object paths are strings and byte arrays base64 strings. A file descriptor
+is {"fd": i}, the i-th one sent along with the request (SCM_RIGHTS) or
+returned along with the reply.
+
+Requests are handled as soon as they are read, on the GUI thread, without
+going through the bus daemon; waitFor replies when the output arrives.
+*/
+class ControlServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ControlServer(QObject *parent = nullptr);
+    ~ControlServer() override;
+
+    bool listen(const QString &path);
+    QString errorString() const { return m_error; }
+
+private:
+    void acceptConnection();
+
+    int m_fd;
+    QString m_path;
+    QString m_error;
+    QSocketNotifier *m_notifier;
+};
+
+#endif
@@ -5,6 +5,20 @@
 #ifdef HAVE_QDBUS
 Q_DECLARE_METATYPE(QList<QDBusObjectPath>)
 
+// paths are never reused within a process, a stale path finds nothing
+static quint64 lastObjectId = 0;
+
+static QHash<QString, DBusAddressable*> &registry()
+{
+    static QHash<QString, DBusAddressable*> objects;
+    return objects;
+}
+
+DBusAddressable *DBusAddressable::lookup(const QString& path)
+{
+    return registry().value(path);
+}
+
 QString DBusAddressable::getDbusPathString()
 {
     return m_path;
@@ -14,12 +28,73 @@ QDBusObjectPath DBusAddressable::getDbusPath()
 {
     return QDBusObjectPath(m_path);
 }
+
+QVariant fromDbusVariant(const QVariant &value)
+{
+    if (value.userType() == qMetaTypeId<QDBusVariant>())
+        return fromDbusVariant(value.value<QDBusVariant>().variant());
+    if (value.userType() == QMetaType::QVariantMap)
+    {
+        QVariantMap map = value.toMap();
+        for (auto it = map.begin(); it != map.end(); ++it)
+            it.value() = fromDbusVariant(it.value());
+        return map;
+    }
+    if (value.userType() == QMetaType::QVariantList)
+    {
+        QVariantList list = value.toList();
+        for (QVariant &item : list)
+            item = fromDbusVariant(item);
+        return list;
+    }
+    if (value.userType() != qMetaTypeId<QDBusArgument>())
+        return value;
+
+    const QDBusArgument arg = value.value<QDBusArgument>();
+    switch (arg.currentType())
+    {
+    case QDBusArgument::MapType:
+    {
+        QVariantMap map;
+        arg.beginMap();
+        while (!arg.atEnd())
+        {
+            arg.beginMapEntry();
+            const QString key = arg.asVariant().toString();
+            map.insert(key, fromDbusVariant(arg.asVariant()));
+            arg.endMapEntry();
+        }
+        arg.endMap();
+        return map;
+    }
+    case QDBusArgument::ArrayType:
+    {
+        QVariantList list;
+        arg.beginArray();
+        while (!arg.atEnd())
+            list.append(fromDbusVariant(arg.asVariant()));
+        arg.endArray();
+        return list;
+    }
+    default:
+        return arg.asVariant();
+    }
+}
 #endif
 
 DBusAddressable::DBusAddressable(const QString& prefix)
 {
     #ifdef HAVE_QDBUS
-    QString uuidString = QUuid::createUuid().toString();
-    m_path = prefix + QLatin1Char('/') + uuidString.replace(QRegularExpression(QStringLiteral("[\\{\\}\\-]")), QString());
+    m_path = prefix + QLatin1Char('/') + QString::number(++lastObjectId);
+    registry().insert(m_path, this);
+    #else
+    Q_UNUSED(prefix);
+    #endif
+}
+
+DBusAddressable::~DBusAddressable()
+{
+    #ifdef HAVE_QDBUS
+    registry().remove(m_path);
     #endif
 }
@@ -1,11 +1,9 @@
 #ifndef DBUSADDRESSABLE_H
 #define DBUSADDRESSABLE_H
 
-#include <QRegularExpression>
 #include <QString>
 #ifdef HAVE_QDBUS
 #include <QtDBus/QtDBus>
-#include <QUuid>
 #endif
 
 class DBusAddressable
@@ -18,8 +16,11 @@ class DBusAddressable
     #ifdef HAVE_QDBUS
         QDBusObjectPath getDbusPath();
         QString getDbusPathString();
+        // the living object with that path, without asking the bus
+        static DBusAddressable *lookup(const QString& path);
     #endif
         DBusAddressable(const QString& prefix);
+        virtual ~DBusAddressable();
 };
 
 #ifdef HAVE_QDBUS
@@ -29,6 +30,17 @@ template <class AClass, class WClass> void registerAdapter(WClass *obj)
     QString path = dynamic_cast<DBusAddressable*>(obj)->getDbusPathString();
     QDBusConnection::sessionBus().registerObject(path, obj);
 }
+
+/*! Nested containers in a{sv} arguments arrive as QDBusArgument; this
+    turns them into QVariantMap and QVariantList all the way down.
+ */
+QVariant fromDbusVariant(const QVariant &value);
+
+// nullptr if nothing of that class is registered at the path
+template <class T> T *findDbusObject(const QDBusObjectPath &path)
+{
+    return dynamic_cast<T*>(DBusAddressable::lookup(path.path()));
+}
 #endif
 
 
@@ -0,0 +1,419 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by LXQt team                                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include <QByteArrayMatcher>
+#include <QCheckBox>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QLineEdit>
+#include <QScrollBar>
+#include <QThread>
+#include <QTimer>
+#include <QTreeWidget>
+#include <QVBoxLayout>
+
+#include "findallwidget.h"
+#include "mainwindow.h"
+#include "qterminalapp.h"
+#include "tabwidget.h"
+#include "termwidgetholder.h"
+#include "termwidget.h"
+#include "qterminalutils.h"
+
+#include <algorithm>
+
+// Limits that keep a pathological pattern (e.g. a single space) from
+// flooding the tree with millions of rows.
+static const int MAX_MATCHES_PER_TERMINAL = 1000;
+static const int MATCH_BATCH = 64;
+// of the most recent scrollback that is searched in every terminal
+static const qsizetype MAX_SNAPSHOT_BYTES = 32 * 1024 * 1024;
+
+/*! The end of what saveHistory() writes, in whole lines. The older lines
+    are dropped as they are written, so a huge scrollback never has to be
+    held in memory at once.
+ */
+class HistoryTail : public QIODevice
+{
+public:
+    explicit HistoryTail(qsizetype limit)
+        : m_limit(limit)
+        , m_droppedLines(0)
+    {
+    }
+
+    // once saveHistory() is done
+    QByteArray data()
+    {
+        trim();
+        return m_data;
+    }
+    int droppedLines() const { return m_droppedLines; }
+
+protected:
+    qint64 readData(char *data, qint64 maxSize) override
+    {
+        Q_UNUSED(data);
+        Q_UNUSED(maxSize);
+        return -1;
+    }
+
+    qint64 writeData(const char *data, qint64 size) override
+    {
+        m_data.append(data, size);
+        // trimmed in batches, not on every write
+        if (m_data.size() > 2 * m_limit)
+            trim();
+        return size;
+    }
+
+private:
+    void trim()
+    {
+        if (m_data.size() <= m_limit)
+            return;
+        // a single line longer than the limit is kept as it is
+        const qsizetype cut = m_data.indexOf('\n', m_data.size() - m_limit - 1);
+        if (cut == -1)
+            return;
+        m_droppedLines += static_cast<int>(std::count(m_data.cbegin(), m_data.cbegin() + cut + 1, '\n'));
+        m_data.remove(0, cut + 1);
+    }
+
+    qsizetype m_limit;
+    int m_droppedLines;
+    QByteArray m_data;
+};
+
+FindAllWidget::FindAllWidget(MainWindow *window, QWidget *parent)
+    : QWidget(parent)
+    , m_window(window)
+    , m_pattern(new QLineEdit(this))
+    , m_caseSensitive(new QCheckBox(tr("Match case"), this))
+    , m_allWindows(new QCheckBox(tr("All windows"), this))
+    , m_status(new QLabel(this))
+    , m_results(new QTreeWidget(this))
+    , m_nextSnapshot(0)
+    , m_pending(0)
+    , m_matchCount(0)
+    , m_generation(0)
+    , m_cancel(std::make_shared<std::atomic_bool>(false))
+{
+    // leave at least one core for the GUI thread and the shells
+    m_pool.setMaxThreadCount(qMax(1, QThread::idealThreadCount() - 1));
+
+    m_pattern->setPlaceholderText(tr("Find in all terminals"));
+    m_pattern->setClearButtonEnabled(true);
+
+    m_results->setHeaderHidden(true);
+    m_results->setUniformRowHeights(true);
+    m_results->setRootIsDecorated(true);
+
+    QHBoxLayout *bar = new QHBoxLayout;
+    bar->setContentsMargins(0, 0, 0, 0);
+    bar->addWidget(m_pattern, 1);
+    bar->addWidget(m_caseSensitive);
+    bar->addWidget(m_allWindows);
+
+    QVBoxLayout *lay = new QVBoxLayout(this);
+    lay->setContentsMargins(2, 2, 2, 2);
+    lay->addLayout(bar);
+    lay->addWidget(m_status);
+    lay->addWidget(m_results, 1);
+    setLayout(lay);
+
+    connect(m_pattern, &QLineEdit::returnPressed, this, &FindAllWidget::startSearch);
+    connect(m_results, &QTreeWidget::itemActivated, this, [this](QTreeWidgetItem *item) {
+        activateResult(item);
+    });
+}
+
+FindAllWidget::~FindAllWidget()
+{
+    // workers post their results to this object, so they must not outlive it
+    m_cancel->store(true);
+    m_pool.clear();
+    m_pool.waitForDone();
+}
+
+void FindAllWidget::focusSearch()
+{
+    m_pattern->setFocus(Qt::OtherFocusReason);
+    m_pattern->selectAll();
+}
+
+void FindAllWidget::cancelSearch()
+{
+    m_cancel->store(true);
+    m_cancel = std::make_shared<std::atomic_bool>(false);
+    m_pool.clear();
+    ++m_generation;
+    m_targets.clear();
+    m_nextSnapshot = 0;
+    m_pending = 0;
+}
+
+void FindAllWidget::startSearch()
+{
+    cancelSearch();
+    m_results->clear();
+    m_matchCount = 0;
+
+    if (m_pattern->text().isEmpty() || m_window.isNull())
+    {
+        updateStatus();
+        return;
+    }
+
+    if (m_allWindows->isChecked())
+    {
+        const QList<MainWindow*> windows = QTerminalApp::Instance()->getWindowList();
+        int n = 0;
+        for (MainWindow *w : windows)
+        {
+            collectTargets(w, windows.size() > 1 ? tr("Window %1").arg(++n) + QStringLiteral(": ") : QString());
+        }
+    }
+    else
+    {
+        collectTargets(m_window, QString());
+    }
+
+    updateStatus();
+    QTimer::singleShot(0, this, &FindAllWidget::snapshotNext);
+}
+
+void FindAllWidget::collectTargets(MainWindow *window, const QString &windowLabel)
+{
+    TabWidget *tabs = window->tabWidget();
+    for (int i = 0; i < tabs->count(); ++i)
+    {
+        TermWidgetHolder *holder = qobject_cast<TermWidgetHolder*>(tabs->widget(i));
+        if (holder == nullptr)
+            continue;
+        const QList<TermWidget*> terminals = holder->findChildren<TermWidget*>();
+        int pane = 0;
+        for (TermWidget *term : terminals)
+        {
+            QString label = windowLabel + tabs->tabText(i);
+            if (terminals.size() > 1)
+                label += QStringLiteral(" [%1]").arg(++pane);
+            m_targets.append({window, holder, term, label, nullptr});
+        }
+    }
+}
+
+void FindAllWidget::snapshotNext()
+{
+    if (m_nextSnapshot >= m_targets.size())
+        return;
+
+    const int index = m_nextSnapshot++;
+    const Target &target = m_targets.at(index);
+    // a lazy terminal that has never been shown has no scrollback yet
+    if (!target.terminal.isNull() && !target.terminal->isPending())
+    {
+        // Copying the scrollback is the only part that has to run on the GUI
+        // thread, one terminal per iteration. saveHistory() exports all of
+        // it in one call, only the most recent part is kept for the scan.
+        TermWidgetImpl *impl = target.terminal->impl();
+        HistoryTail tail(MAX_SNAPSHOT_BYTES);
+        tail.open(QIODevice::WriteOnly);
+        impl->saveHistory(&tail);
+        tail.close();
+
+        const QByteArray data = tail.data();
+        const int droppedLines = tail.droppedLines();
+        const int columns = impl->screenColumnsCount();
+        const int totalRows = impl->historyLinesCount() + impl->screenLinesCount();
+        const QString pattern = m_pattern->text();
+        const Qt::CaseSensitivity cs = m_caseSensitive->isChecked() ? Qt::CaseSensitive : Qt::CaseInsensitive;
+        const int generation = m_generation;
+        const std::shared_ptr<std::atomic_bool> cancel = m_cancel;
+
+        ++m_pending;
+        m_pool.start([this, data, droppedLines, columns, totalRows, pattern, cs, generation, cancel, index] {
+            QList<Match> batch;
+            int found = 0;
+            auto flush = [&](bool done) {
+                if (cancel->load())
+                    return;
+                QMetaObject::invokeMethod(this, [this, generation, index, batch, done] {
+                    addMatches(generation, index, batch, done);
+                }, Qt::QueuedConnection);
+                batch.clear();
+            };
+            // saveHistory() writes a wrapped line as one, the terminal has rows
+            auto rowsOf = [&](qsizetype start, qsizetype end) {
+                // no character takes more cells than it has bytes
+                if (end - start <= columns)
+                    return 1;
+                return static_cast<int>(wrap_line(QString::fromUtf8(data.constData() + start, end - start), columns).size());
+            };
+            auto report = [&](int line, int row, qsizetype start, qsizetype end) {
+                batch.append({line, row, rowsOf(start, end), QString::fromUtf8(data.constData() + start, end - start).trimmed()});
+                ++found;
+                if (batch.size() >= MATCH_BATCH)
+                    flush(false);
+            };
+
+            const char *begin = data.constData();
+            const qsizetype size = data.size();
+            // the rows of a truncated scrollback are counted from the end
+            int firstRow = 0;
+            if (droppedLines > 0)
+            {
+                int rows = 0;
+                for (qsizetype start = 0; start < size && !cancel->load();)
+                {
+                    qsizetype end = data.indexOf('\n', start);
+                    if (end == -1)
+                        end = size;
+                    rows += rowsOf(start, end);
+                    start = end + 1;
+                }
+                firstRow = qMax(0, totalRows - rows);
+            }
+            if (cs == Qt::CaseSensitive)
+            {
+                // search the raw bytes and only count the lines between the hits
+                const QByteArrayMatcher matcher(pattern.toUtf8());
+                qsizetype from = 0;
+                qsizetype counted = 0;
+                int line = droppedLines;
+                int row = firstRow;
+                qsizetype pos;
+                while (found < MAX_MATCHES_PER_TERMINAL && !cancel->load()
+                       && (pos = matcher.indexIn(data, from)) != -1)
+                {
+                    const qsizetype start = data.lastIndexOf('\n', pos) + 1;
+                    while (counted < start)
+                    {
+                        const qsizetype next = data.indexOf('\n', counted);
+                        row += rowsOf(counted, next);
+                        ++line;
+                        counted = next + 1;
+                    }
+                    qsizetype end = data.indexOf('\n', pos);
+                    if (end == -1)
+                        end = size;
+                    report(line, row, start, end);
+                    from = end + 1;
+                }
+            }
+            else
+            {
+                qsizetype start = 0;
+                int line = droppedLines;
+                int row = firstRow;
+                while (start < size && found < MAX_MATCHES_PER_TERMINAL && !cancel->load())
+                {
+                    qsizetype end = data.indexOf('\n', start);
+                    if (end == -1)
+                        end = size;
+                    if (QString::fromUtf8(begin + start, end - start).contains(pattern, Qt::CaseInsensitive))
+                        report(line, row, start, end);
+                    row += rowsOf(start, end);
+                    start = end + 1;
+                    ++line;
+                }
+            }
+            flush(true);
+        });
+    }
+
+    if (m_nextSnapshot < m_targets.size())
+        QTimer::singleShot(0, this, &FindAllWidget::snapshotNext);
+    updateStatus();
+}
+
+void FindAllWidget::addMatches(int generation, int index, const QList<Match> &matches, bool done)
+{
+    if (generation != m_generation || index >= m_targets.size())
+        return;
+
+    if (done)
+        --m_pending;
+
+    Target &target = m_targets[index];
+    if (!matches.isEmpty())
+    {
+        if (target.group == nullptr)
+        {
+            target.group = new QTreeWidgetItem(m_results);
+            target.group->setData(0, Qt::UserRole, index);
+            target.group->setExpanded(true);
+        }
+        for (const Match &match : matches)
+        {
+            QTreeWidgetItem *item = new QTreeWidgetItem(target.group);
+            item->setText(0, QStringLiteral("%1: %2").arg(match.line + 1).arg(match.text));
+            item->setData(0, Qt::UserRole, match.row);
+            item->setData(0, Qt::UserRole + 1, match.rows);
+        }
+        m_matchCount += matches.size();
+        target.group->setText(0, QStringLiteral("%1 (%2)").arg(target.label).arg(target.group->childCount()));
+    }
+    updateStatus();
+}
+
+void FindAllWidget::updateStatus()
+{
+    if (m_nextSnapshot < m_targets.size() || m_pending > 0)
+        m_status->setText(tr("Searching %1 terminals... %2 matches").arg(m_targets.size()).arg(m_matchCount));
+    else if (!m_targets.isEmpty())
+        m_status->setText(tr("%1 matches in %2 terminals").arg(m_matchCount).arg(m_targets.size()));
+    else
+        m_status->clear();
+}
+
+void FindAllWidget::activateResult(QTreeWidgetItem *item)
+{
+    QTreeWidgetItem *group = item->parent();
+    if (group == nullptr)
+        return;
+
+    const int index = group->data(0, Qt::UserRole).toInt();
+    const int row = item->data(0, Qt::UserRole).toInt();
+    const int rows = item->data(0, Qt::UserRole + 1).toInt();
+    if (index < 0 || index >= m_targets.size())
+        return;
+
+    const Target &target = m_targets.at(index);
+    if (target.window.isNull() || target.holder.isNull() || target.terminal.isNull()
+        || target.terminal->isPending())
+    {
+        // the terminal has been closed since the search
+        group->setDisabled(true);
+        return;
+    }
+
+    target.window->activateWindow();
+    target.window->raise();
+    target.window->tabWidget()->setCurrentWidget(target.holder);
+    target.terminal->setFocus(Qt::OtherFocusReason);
+
+    TermWidgetImpl *impl = target.terminal->impl();
+    // all rows of a wrapped line
+    impl->setSelectionStart(row, 0);
+    impl->setSelectionEnd(row + qMax(1, rows) - 1, impl->screenColumnsCount());
+    if (QScrollBar *scrollBar = impl->findChild<QScrollBar*>())
+    {
+        scrollBar->setValue(qMax(0, row - impl->screenLinesCount() / 2));
+    }
+}
@@ -0,0 +1,102 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by LXQt team                                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#ifndef FINDALLWIDGET_H
+#define FINDALLWIDGET_H
+
+#include <QWidget>
+#include <QPointer>
+#include <QThreadPool>
+
+#include <atomic>
+#include <memory>
+
+class QLineEdit;
+class QCheckBox;
+class QLabel;
+class QTreeWidget;
+class QTreeWidgetItem;
+class MainWindow;
+class TermWidgetHolder;
+class TermWidget;
+
+/*! \brief "Find in all terminals" panel.
+
+The scrollback of every terminal (of this window or of all windows) is
+copied on the GUI thread, one terminal per event loop iteration, and
+scanned on a private thread pool. Matches are streamed back grouped by
+tab, so the UI never waits for the whole scan to finish. QTermWidget
+exports a scrollback only as a whole, so the copy of a single terminal
+still takes one iteration; only its most recent 32 MiB are kept and
+searched.
+*/
+class FindAllWidget : public QWidget
+{
+    Q_OBJECT
+
+public:
+    FindAllWidget(MainWindow *window, QWidget *parent = nullptr);
+    ~FindAllWidget() override;
+
+    void focusSearch();
+
+public slots:
+    void startSearch();
+    void cancelSearch();
+
+private slots:
+    void snapshotNext();
+    void activateResult(QTreeWidgetItem *item);
+
+private:
+    struct Target {
+        QPointer<MainWindow> window;
+        QPointer<TermWidgetHolder> holder;
+        QPointer<TermWidget> terminal;
+        QString label;
+        QTreeWidgetItem *group;
+    };
+
+    struct Match {
+        int line;
+        // where the line is on the terminal, and how many rows it wraps to
+        int row;
+        int rows;
+        QString text;
+    };
+
+    void collectTargets(MainWindow *window, const QString &windowLabel);
+    void addMatches(int generation, int target, const QList<Match> &matches, bool done);
+    void updateStatus();
+
+    QPointer<MainWindow> m_window;
+    QLineEdit *m_pattern;
+    QCheckBox *m_caseSensitive;
+    QCheckBox *m_allWindows;
+    QLabel *m_status;
+    QTreeWidget *m_results;
+
+    QList<Target> m_targets;
+    int m_nextSnapshot;
+    int m_pending;
+    int m_matchCount;
+    int m_generation;
+    std::shared_ptr<std::atomic_bool> m_cancel;
+    QThreadPool m_pool;
+};
+
+#endif
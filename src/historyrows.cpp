@@ -0,0 +1,79 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by LXQt team                                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include "historyrows.h"
+#include "qterminalutils.h"
+
+HistoryRows::HistoryRows(int columns, int first, int count)
+    : m_columns(columns)
+    , m_first(first)
+    , m_count(qMax(0, count))
+    , m_rowCount(0)
+    , m_decoder(QStringDecoder::Utf8)
+{
+    open(QIODevice::WriteOnly);
+}
+
+QStringList HistoryRows::rows() const
+{
+    if (m_first >= 0)
+        return m_rows;
+    // the last -first rows were kept, and count of them are asked for
+    return m_rows.mid(0, m_count);
+}
+
+qint64 HistoryRows::readData(char *data, qint64 maxSize)
+{
+    Q_UNUSED(data);
+    Q_UNUSED(maxSize);
+    return -1;
+}
+
+qint64 HistoryRows::writeData(const char *data, qint64 size)
+{
+    m_partial += m_decoder.decode(QByteArrayView(data, size));
+    qsizetype start = 0;
+    qsizetype end;
+    while ((end = m_partial.indexOf(QLatin1Char('\n'), start)) != -1)
+    {
+        addLine(QStringView(m_partial).mid(start, end - start));
+        start = end + 1;
+    }
+    m_partial.remove(0, start);
+    return size;
+}
+
+void HistoryRows::addLine(QStringView line)
+{
+    const QList<qsizetype> starts = wrap_line(line, m_columns);
+    for (int i = 0; i < starts.size(); ++i)
+    {
+        const qsizetype end = i + 1 < starts.size() ? starts.at(i + 1) : line.size();
+        const int row = m_rowCount++;
+        if (m_first >= 0)
+        {
+            if (row >= m_first && row - m_first < m_count)
+                m_rows.append(line.mid(starts.at(i), end - starts.at(i)).toString());
+        }
+        else
+        {
+            m_rows.append(line.mid(starts.at(i), end - starts.at(i)).toString());
+            if (m_rows.size() > -m_first)
+                m_rows.removeFirst();
+        }
+    }
+}
@@ -0,0 +1,63 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by LXQt team                                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#ifndef HISTORYROWS_H
+#define HISTORYROWS_H
+
+#include <QIODevice>
+#include <QStringDecoder>
+#include <QStringList>
+
+/*! \brief Rows of a terminal, collected from QTermWidget::saveHistory().
+
+saveHistory() writes logical lines: a line that wraps on screen is a
+single line there. This device splits them into rows again at the current
+width, see wrap_line(), so that row numbers match those of the terminal,
+e.g. for selections and historyLinesCount(). Rows wrapped at an earlier
+width are not told apart.
+
+Only the rows asked for are kept, so a long scrollback is streamed through
+rather than copied: \a first counts from the top, or from the end if it is
+negative, and \a count rows are kept from there.
+*/
+class HistoryRows : public QIODevice
+{
+public:
+    HistoryRows(int columns, int first, int count);
+
+    // the rows asked for, once saveHistory() is done
+    QStringList rows() const;
+    // all rows written
+    int rowCount() const { return m_rowCount; }
+
+protected:
+    qint64 readData(char *data, qint64 maxSize) override;
+    qint64 writeData(const char *data, qint64 size) override;
+
+private:
+    void addLine(QStringView line);
+
+    int m_columns;
+    int m_first;
+    int m_count;
+    int m_rowCount;
+    QStringDecoder m_decoder;
+    QString m_partial;
+    QStringList m_rows;
+};
+
+#endif
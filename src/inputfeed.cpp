@@ -0,0 +1,123 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by LXQt team                                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include <QSocketNotifier>
+#include <QTimer>
+
+#include <QByteArray>
+
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "inputfeed.h"
+
+static const int FEED_RETRY_INTERVAL = 10;
+
+/* A pipe is opened anew, so that it can be made non-blocking without
+   touching the flags of the sender, which shares the open file description
+   of a passed descriptor. A socket is read with MSG_DONTWAIT instead, and
+   anything else, e.g. a regular file, is only read when it is readable. */
+static int ownDescriptor(int fd, bool &socket)
+{
+    struct stat info;
+    socket = ::fstat(fd, &info) == 0 && S_ISSOCK(info.st_mode);
+    if (socket || !S_ISFIFO(info.st_mode))
+        return fd;
+    const QByteArray path = "/proc/self/fd/" + QByteArray::number(fd);
+    const int reopened = ::open(path.constData(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+    if (reopened < 0)
+        return fd;
+    ::close(fd);
+    return reopened;
+}
+
+InputFeed::InputFeed(int fd, QObject *parent)
+    : QObject(parent)
+    , m_socket(false)
+    , m_fd(ownDescriptor(fd, m_socket))
+    , m_notifier(new QSocketNotifier(m_fd, QSocketNotifier::Read, this))
+    , m_retryTimer(new QTimer(this))
+    , m_decoder(QStringDecoder::Utf8)
+{
+    m_notifier->setEnabled(false);
+    connect(m_notifier, &QSocketNotifier::activated, this, &InputFeed::readChunk);
+
+    m_retryTimer->setSingleShot(true);
+    m_retryTimer->setInterval(FEED_RETRY_INTERVAL);
+    connect(m_retryTimer, &QTimer::timeout, this, &InputFeed::resume);
+}
+
+InputFeed::~InputFeed()
+{
+    close();
+}
+
+void InputFeed::start()
+{
+    resume();
+}
+
+void InputFeed::resume()
+{
+    if (m_fd < 0)
+        return;
+    if (m_backlog && m_backlog() >= HighWater)
+    {
+        m_retryTimer->start();
+        return;
+    }
+    m_notifier->setEnabled(true);
+}
+
+void InputFeed::readChunk()
+{
+    m_notifier->setEnabled(false);
+
+    char buffer[ChunkSize];
+    const ssize_t count = m_socket ? ::recv(m_fd, buffer, sizeof(buffer), MSG_DONTWAIT)
+                                   : ::read(m_fd, buffer, sizeof(buffer));
+    if (count > 0)
+    {
+        const QString decoded = m_decoder.decode(QByteArrayView(buffer, count));
+        if (!decoded.isEmpty())
+            emit text(decoded);
+        QTimer::singleShot(0, this, &InputFeed::resume);
+        return;
+    }
+    if (count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR))
+    {
+        m_notifier->setEnabled(true);
+        return;
+    }
+
+    close();
+    emit finished();
+}
+
+void InputFeed::close()
+{
+    if (m_fd < 0)
+        return;
+    // the notifier must not watch a closed descriptor
+    m_notifier->setEnabled(false);
+    m_retryTimer->stop();
+    ::close(m_fd);
+    m_fd = -1;
+}
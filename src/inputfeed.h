@@ -0,0 +1,82 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by LXQt team                                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#ifndef INPUTFEED_H
+#define INPUTFEED_H
+
+#include <QObject>
+#include <QStringDecoder>
+
+#include <functional>
+
+class QSocketNotifier;
+class QTimer;
+
+/*! \brief Input for a terminal read from a file descriptor.
+
+The descriptor is read in chunks as it becomes readable, and every chunk is
+emitted as text, decoded as UTF-8 across chunk boundaries. After a chunk the
+feed rests for a turn of the event loop, so that the terminal can write it
+to its pty, and it does not read on while the backlog (the input the program
+in the terminal has not read yet) is above a high-water mark. A writer faster
+than that program blocks on the full pipe instead of filling a buffer here.
+
+The mark is well below the 4 KiB input queue of a tty: in canonical mode
+the queue only reports complete lines, and never more than 4095 bytes.
+Chunks are as small, so that little more than the mark ever waits in the
+write buffer of the terminal.
+
+The flags of the descriptor are left alone, since the sender shares them;
+a pipe is opened anew to read it without blocking. The descriptor is
+closed at its end, on an error, or with the feed.
+*/
+class InputFeed : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int ChunkSize = 1024;
+    // the program in the terminal is behind while this much waits for it
+    static constexpr int HighWater = 1024;
+
+    // takes over \a fd
+    explicit InputFeed(int fd, QObject *parent = nullptr);
+    ~InputFeed() override;
+
+    void setBacklog(const std::function<int()> &backlog) { m_backlog = backlog; }
+    void start();
+    bool isOpen() const { return m_fd >= 0; }
+
+signals:
+    void text(const QString &text);
+    void finished();
+
+private:
+    void resume();
+    void readChunk();
+    void close();
+
+    // read with recv(), which need not block
+    bool m_socket;
+    int m_fd;
+    QSocketNotifier *m_notifier;
+    QTimer *m_retryTimer;
+    QStringDecoder m_decoder;
+    std::function<int()> m_backlog;
+};
+
+#endif
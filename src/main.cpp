@@ -28,7 +28,7 @@
 
 #ifdef HAVE_QDBUS
     #include <QtDBus/QtDBus>
-    #include "processadaptor.h"
+    #include "controlsocket.h"
 #endif
 
 
@@ -39,10 +39,7 @@
 
 #define out
 
-const char* const short_options = "vhw:e:dp:";
-
-static const char* serviceName = "org.lxqt.QTerminal";
-static const char* ifaceName = "org.lxqt.QTerminal.Process";
+const char* const short_options = "vhw:e:dp:s:";
 
 const struct option long_options[] = {
     {"version", 0, nullptr, 'v'},
@@ -51,19 +48,24 @@ const struct option long_options[] = {
     {"execute", 1, nullptr, 'e'},
     {"drop",    0, nullptr, 'd'},
     {"profile", 1, nullptr, 'p'},
+    {"session", 1, nullptr, 's'},
+    {"headless", 0, nullptr, 'H'},
+    {"control-socket", 1, nullptr, 'C'},
     {nullptr,   0, nullptr,  0}
 };
 
-QTerminalApp * QTerminalApp::m_instance = nullptr;
-
 [[ noreturn ]] void print_usage_and_exit(int code)
 {
     printf("QTerminal %s\n", QTERMINAL_VERSION);
     puts("Usage: qterminal [OPTION]...\n");
+    puts("       --control-socket <path>");
+    puts("                            Accept remote control requests on a Unix socket");
     puts("  -d,  --drop               Start in \"dropdown mode\" (like Yakuake or Tilda)");
     puts("  -e,  --execute <command>  Execute command instead of shell");
     puts("  -h,  --help               Print this help");
+    puts("       --headless           Run without a display, controlled over D-Bus or a control socket only");
     puts("  -p,  --profile <name>     Load profile from ~/.config/<name>.conf");
+    puts("  -s,  --session <name>     Restore the windows and tabs of a saved session");
     puts("  -v,  --version            Prints application version and exits");
     puts("  -w,  --workdir <dir>      Start session with specified work directory");
     puts("\nHomepage: <https://github.com/lxqt/qterminal>");
@@ -77,10 +79,12 @@ QTerminalApp * QTerminalApp::m_instance = nullptr;
     exit(code);
 }
 
-void parse_args(int argc, char* argv[], QString& workdir, QStringList & shell_command, out bool& dropMode)
+void parse_args(int argc, char* argv[], QString& workdir, QStringList & shell_command, out bool& dropMode, out QString& session,
+                out bool& headless, out QString& controlSocket)
 {
     int next_option = 0;
     dropMode = false;
+    headless = false;
     do{
         next_option = getopt_long(argc, argv, short_options, long_options, nullptr);
         switch(next_option)
@@ -107,6 +111,15 @@ void parse_args(int argc, char* argv[], QString& workdir, QStringList & shell_co
             case 'p':
                 Properties::Instance(QString::fromLocal8Bit(optarg));
                 break;
+            case 's':
+                session = QString::fromLocal8Bit(optarg);
+                break;
+            case 'H':
+                headless = true;
+                break;
+            case 'C':
+                controlSocket = QString::fromLocal8Bit(optarg);
+                break;
             case '?':
                 print_usage_and_exit(1);
                 break;
@@ -123,6 +136,26 @@ void parse_args(int argc, char* argv[], QString& workdir, QStringList & shell_co
     {
         dropMode = false;
     }
+    // there is no screen to drop down from
+    if (headless)
+    {
+        dropMode = false;
+    }
+}
+
+// The platform plugin is chosen when the application object is created,
+// before the options are parsed.
+static bool has_headless_arg(int argc, char* argv[])
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        if (qstrcmp(argv[i], "--headless") == 0)
+            return true;
+        // what follows is the command to execute
+        if (qstrcmp(argv[i], "-e") == 0 || qstrcmp(argv[i], "--execute") == 0)
+            break;
+    }
+    return false;
 }
 
 int main(int argc, char *argv[])
@@ -148,12 +181,19 @@ int main(int argc, char *argv[])
     // Warning: do not change settings format. It can screw bookmarks later.
     QSettings::setDefaultFormat(QSettings::IniFormat);
 
+    if (has_headless_arg(argc, argv))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
     QTerminalApp *app = QTerminalApp::Instance(argc, argv);
 
     QString workdir;
     QStringList shell_command;
     bool dropMode = false;
-    parse_args(argc, argv, workdir, shell_command, dropMode);
+    QString session;
+    bool headless = false;
+    QString controlSocket;
+    parse_args(argc, argv, workdir, shell_command, dropMode, session, headless, controlSocket);
+    app->setHeadless(headless);
 
     #ifdef HAVE_QDBUS
         app->registerOnDbus(dropMode);
@@ -165,6 +205,21 @@ int main(int argc, char *argv[])
         return 0;
     }
 
+    #ifdef HAVE_QDBUS
+    if (!controlSocket.isEmpty())
+    {
+        ControlServer *server = new ControlServer(app);
+        if (!server->listen(controlSocket))
+        {
+            fprintf(stderr, "Cannot listen on %s: %s\n", qPrintable(controlSocket), qPrintable(server->errorString()));
+            delete server;
+        }
+    }
+    #else
+    if (!controlSocket.isEmpty())
+        fprintf(stderr, "The control socket needs QTerminal built with D-Bus support.\n");
+    #endif
+
     Properties::Instance()->migrate_settings();
     Properties::Instance()->loadSettings();
 
@@ -220,179 +275,22 @@ int main(int argc, char *argv[])
         app->installTranslator(&translator);
     }
 
-    TerminalConfig initConfig = TerminalConfig(workdir, shell_command);
-    app->newWindow(dropMode, initConfig);
-
-    int ret = app->exec();
-    delete Properties::Instance();
-    app->cleanup();
-
-    return ret;
-}
-
-MainWindow *QTerminalApp::newWindow(bool dropMode, TerminalConfig &cfg)
-{
-    MainWindow *window = nullptr;
-    if (dropMode)
-    {
-        window = new MainWindow(cfg, dropMode);
-        if (Properties::Instance()->dropShowOnStart)
-            window->show();
-    }
-    else
-    {
-        window = new MainWindow(cfg, dropMode);
-        if (Properties::Instance()->saveSizeOnExit
-            && Properties::Instance()->windowMaximized)
-        {
-            window->setWindowState(Qt::WindowMaximized);
-        }
-        window->show();
-    }
-    return window;
-}
-
-QTerminalApp *QTerminalApp::Instance()
-{
-    assert(m_instance != nullptr);
-    return m_instance;
-}
-
-QTerminalApp *QTerminalApp::Instance(int &argc, char **argv)
-{
-    assert(m_instance == nullptr);
-    m_instance = new QTerminalApp(argc, argv);
-    return m_instance;
-}
-
-QTerminalApp::QTerminalApp(int &argc, char **argv)
-    :QApplication(argc, argv)
-{
-}
-
-QString &QTerminalApp::getWorkingDirectory()
-{
-    return m_workDir;
-}
-
-void QTerminalApp::setWorkingDirectory(const QString &wd)
-{
-    m_workDir = wd;
-}
-
-void QTerminalApp::cleanup() {
-    delete m_instance;
-    m_instance = nullptr;
-}
-
-
-void QTerminalApp::addWindow(MainWindow *window)
-{
-    m_windowList.append(window);
-}
-
-void QTerminalApp::removeWindow(MainWindow *window)
-{
-    m_windowList.removeOne(window);
-}
-
-QList<MainWindow *> QTerminalApp::getWindowList()
-{
-    return m_windowList;
-}
-
-#ifdef HAVE_QDBUS
-void QTerminalApp::registerOnDbus(bool dropDown)
-{
-    if (!QDBusConnection::sessionBus().isConnected())
-    {
-        fprintf(stderr, "Cannot connect to the D-Bus session bus.\n"
-                "To start it, run:\n"
-                "\teval `dbus-launch --auto-syntax`\n");
-        return;
-    }
-
-    if (dropDown)
+    bool restored = false;
+    if (!session.isEmpty() && !dropMode)
     {
-        if (!QDBusConnection::sessionBus().registerService(QLatin1String(serviceName)))
-        {
-            m_isPrimaryInstance = false;
-            return;
-        }
-        new ProcessAdaptor(this);
-        QDBusConnection::sessionBus().registerObject(QStringLiteral("/"), this);
-    }
-    else
-    {
-        if (!QDBusConnection::sessionBus().registerService(QLatin1String(serviceName)
-                                                           + QStringLiteral("-%1").arg(getpid())))
-        {
-            fprintf(stderr, "%s\n", qPrintable(QDBusConnection::sessionBus().lastError().message()));
-            return;
-        }
-        new ProcessAdaptor(this);
-        QDBusConnection::sessionBus().registerObject(QStringLiteral("/"), this);
+        restored = app->restoreWorkspace(app->sessionStore().load(session));
+        if (!restored)
+            qWarning() << "Cannot restore session" << session;
     }
-}
-
-QList<QDBusObjectPath> QTerminalApp::getWindows()
-{
-    QList<QDBusObjectPath> windows;
-    for (MainWindow *wnd : std::as_const(m_windowList))
+    if (!restored)
     {
-        windows.push_back(wnd->getDbusPath());
+        TerminalConfig initConfig = TerminalConfig(workdir, shell_command);
+        app->newWindow(dropMode, initConfig);
     }
-    return windows;
-}
-
-QDBusObjectPath QTerminalApp::newWindow(const QHash<QString,QVariant> &termArgs)
-{
-    TerminalConfig cfg = TerminalConfig::fromDbus(termArgs);
-    MainWindow *wnd = newWindow(false, cfg);
-    assert(wnd != nullptr);
-    return wnd->getDbusPath();
-}
-
-QDBusObjectPath QTerminalApp::getActiveWindow()
-{
-    QWidget *aw = activeWindow();
-    if (aw == nullptr)
-        return QDBusObjectPath("/");
-    return qobject_cast<MainWindow*>(aw)->getDbusPath();
-}
-
-bool QTerminalApp::isDropMode() {
-  if (m_windowList.count() == 0) {
-    return false;
-  }
-  MainWindow *wnd = m_windowList.at(0);
-  return wnd->dropMode();
-}
-
-bool QTerminalApp::toggleDropdown() {
-  if (m_windowList.count() == 0) {
-    return false;
-  }
-  MainWindow *wnd = m_windowList.at(0);
-  if (!wnd->dropMode()) {
-    return false;
-  }
-  wnd->showHide();
-  return true;
-}
 
-void QTerminalApp::requestDropDown()
-{
-    QDBusInterface iface(QLatin1String(serviceName),
-                         QStringLiteral("/"),
-                         QLatin1String(ifaceName), QDBusConnection::sessionBus(), this);
-    iface.call(QStringLiteral("toggleDropdown"));
-}
+    int ret = app->exec();
+    delete Properties::Instance();
+    app->cleanup();
 
-bool QTerminalApp::isPrimaryInstance() {
-  return m_isPrimaryInstance;
+    return ret;
 }
-
-
-#endif
-
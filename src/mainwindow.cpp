@@ -27,6 +27,7 @@
 #include <functional>
 #include <QGuiApplication>
 #include <QActionGroup>
+#include <QInputDialog>
 
 #ifdef HAVE_QDBUS
 #include <QtDBus/QtDBus>
@@ -41,8 +42,10 @@
 #include "properties.h"
 #include "propertiesdialog.h"
 #include "bookmarkswidget.h"
+#include "findallwidget.h"
 #include "qterminalapp.h"
 #include "dbusaddressable.h"
+#include "sessionstore.h"
 
 #include <LayerShellQt/Shell>
 #include <LayerShellQt/Window>
@@ -67,7 +70,10 @@ MainWindow::MainWindow(TerminalConfig &cfg,
       m_config(cfg),
       m_dropLockButton(nullptr),
       m_dropMode(dropMode),
-      m_layerWindow(nullptr)
+      m_layerWindow(nullptr),
+      m_dropShortcut(nullptr),
+      m_enabledTabCount(-1),
+      m_enabledTerminalCount(-1)
 {
 #ifdef HAVE_QDBUS
     registerAdapter<WindowAdaptor, MainWindow>(this);
@@ -102,9 +108,17 @@ MainWindow::MainWindow(TerminalConfig &cfg,
     connect(m_bookmarksDock, &QDockWidget::visibilityChanged,
             this, &MainWindow::bookmarksDock_visibilityChanged);
 
+    m_findAllDock = new QDockWidget(tr("Find in All Terminals"), this);
+    m_findAllDock->setObjectName(QStringLiteral("FindAllDockWidget"));
+    m_findAllDock->setAutoFillBackground(true);
+    m_findAllWidget = new FindAllWidget(this, m_findAllDock);
+    m_findAllWidget->setAutoFillBackground(true);
+    m_findAllDock->setWidget(m_findAllWidget);
+    addDockWidget(Qt::BottomDockWidgetArea, m_findAllDock);
+    m_findAllDock->hide();
+
     connect(actAbout, &QAction::triggered, this, &MainWindow::actAbout_triggered);
     connect(actAboutQt, &QAction::triggered, qApp, &QApplication::aboutQt);
-    connect(&m_dropShortcut, &QxtGlobalShortcut::activated, this, &MainWindow::showHide);
 
     setContentsMargins(0, 0, 0, 0);
     if (m_dropMode) {
@@ -143,12 +157,26 @@ MainWindow::MainWindow(TerminalConfig &cfg,
     setupCustomDirs();
 
     connect(consoleTabulator, &TabWidget::currentTitleChanged, this, &MainWindow::onCurrentTitleChanged);
-    connect(menu_Actions, &QMenu::aboutToShow, this, &MainWindow::updateDisabledActions);
+    connect(consoleTabulator, &TabWidget::tabCountChanged, this, &MainWindow::updateDisabledActions);
+    connect(consoleTabulator, &TabWidget::currentTerminalCountChanged, this, &MainWindow::updateDisabledActions);
+#ifdef HAVE_QDBUS
+    connect(consoleTabulator, &TabWidget::tabOpened, this, [this](QWidget *w) {
+        if (TermWidgetHolder *holder = qobject_cast<TermWidgetHolder*>(w))
+            emit tabOpened(holder->getDbusPath());
+    });
+    // not for a tab that is being destroyed with its window, it is no holder any more
+    connect(consoleTabulator, &TabWidget::tabClosed, this, [this](QWidget *w) {
+        if (TermWidgetHolder *holder = qobject_cast<TermWidgetHolder*>(w))
+            emit tabClosed(holder->getDbusPath());
+    });
+#endif
 
     /* The tab should be added after all changes are made to
        the main window; otherwise, the initial prompt might
        get jumbled because of changes in internal geometry. */
     addNewTab(m_config);
+    // only the first tab of a window being restored starts lazily
+    m_config.setLazy(false);
 }
 
 void MainWindow::rebuildActions()
@@ -161,6 +189,10 @@ void MainWindow::rebuildActions()
     setup_FileMenu_Actions();
     setup_ActionsMenu_Actions();
     setup_ViewMenu_Actions();
+
+    // the new actions have to be checked again
+    m_enabledTabCount = -1;
+    updateDisabledActions();
 }
 
 MainWindow::~MainWindow()
@@ -210,9 +242,15 @@ void MainWindow::setDropShortcut(const QKeySequence& dropShortCut)
     if (!m_dropMode)
         return;
 
-    if (m_dropShortcut.shortcut() != dropShortCut)
+    // only a dropdown window hooks into the key events of the whole desktop
+    if (m_dropShortcut == nullptr)
     {
-        m_dropShortcut.setShortcut(dropShortCut);
+        m_dropShortcut = new QxtGlobalShortcut(this);
+        connect(m_dropShortcut, &QxtGlobalShortcut::activated, this, &MainWindow::showHide);
+    }
+    if (m_dropShortcut->shortcut() != dropShortCut)
+    {
+        m_dropShortcut->setShortcut(dropShortCut);
         qWarning().noquote() << tr("Press \"%1\" to see the terminal.").arg(dropShortCut.toString());
     }
 }
@@ -271,12 +309,18 @@ void MainWindow::setup_ActionsMenu_Actions()
     setup_Action(TAB_NEXT_HISTORY, new QAction(tr("&Next Tab in History"), settingOwner),
                  TAB_NEXT_HISTORY_SHORTCUT, consoleTabulator, SLOT(switchToNext()), menu_Actions, data);
 
+    setup_Action(FIND_TAB, new QAction(tr("F&ind Tab..."), settingOwner),
+                 nullptr, consoleTabulator, SLOT(findTab()), menu_Actions, data);
+
     setup_Action(MOVE_LEFT, new QAction(tr("Move Tab &Left"), settingOwner),
                  MOVE_LEFT_SHORTCUT, consoleTabulator, SLOT(moveLeft()), menu_Actions, data);
 
     setup_Action(MOVE_RIGHT, new QAction(tr("Move Tab &Right"), settingOwner),
                  MOVE_RIGHT_SHORTCUT, consoleTabulator, SLOT(moveRight()), menu_Actions, data);
 
+    setup_Action(TAB_TO_NEW_WINDOW, new QAction(QIcon::fromTheme(QStringLiteral("window-new")), tr("Move Tab to New &Window"), settingOwner),
+                 nullptr, consoleTabulator, SLOT(moveCurrentTabToNewWindow()), menu_Actions, data);
+
     data.setValue(checkHasIndexedTab);
 
     const QString textBase = tr("Tab");
@@ -304,6 +348,12 @@ void MainWindow::setup_ActionsMenu_Actions()
     setup_Action(SUB_COLLAPSE, new QAction(tr("&Close Subterminal"), settingOwner),
                  nullptr, consoleTabulator, SLOT(splitCollapse()), menu_Actions, data);
 
+    setup_Action(SUB_MAXIMIZE, new QAction(QIcon::fromTheme(QStringLiteral("view-fullscreen")), tr("&Maximize/Restore Subterminal"), settingOwner),
+                 nullptr, consoleTabulator, SLOT(toggleMaximizedSubterminal()), menu_Actions, data);
+
+    setup_Action(SUB_TO_NEW_TAB, new QAction(tr("Move Subterminal to New Ta&b"), settingOwner),
+                 nullptr, consoleTabulator, SLOT(moveSubterminalToNewTab()), menu_Actions, data);
+
     setup_Action(SUB_TOP, new QAction(QIcon::fromTheme(QStringLiteral("go-up")), tr("&Top Subterminal"), settingOwner),
                  SUB_TOP_SHORTCUT, consoleTabulator, SLOT(switchTopSubterminal()), menu_Actions, data);
 
@@ -316,6 +366,34 @@ void MainWindow::setup_ActionsMenu_Actions()
     setup_Action(SUB_RIGHT, new QAction(QIcon::fromTheme(QStringLiteral("go-next")), tr("R&ight Subterminal"), settingOwner),
                  SUB_RIGHT_SHORTCUT, consoleTabulator, SLOT(switchRightSubterminal()), menu_Actions, data);
 
+    QMenu *menu_Broadcast = new QMenu(tr("&Broadcast Input"), menu_Actions);
+    QActionGroup *broadcastGroup = new QActionGroup(settingOwner);
+    const std::pair<const char*, QString> broadcastModes[] = {
+        {BROADCAST_OFF, tr("&Off")},
+        {BROADCAST_TAB, tr("To All Subterminals of the &Tab")},
+        {BROADCAST_ALL_TABS, tr("To &All Tabs")},
+        {BROADCAST_SELECTION, tr("To &Selected Terminals")},
+    };
+    for (int mode = TabWidget::BroadcastOff; mode <= TabWidget::BroadcastSelection; ++mode)
+    {
+        QAction *action = new QAction(broadcastModes[mode].second, settingOwner);
+        action->setCheckable(true);
+        action->setChecked(mode == consoleTabulator->broadcastMode());
+        action->setActionGroup(broadcastGroup);
+        connect(action, &QAction::triggered, consoleTabulator, [this, mode] {
+            consoleTabulator->setBroadcastMode(static_cast<TabWidget::BroadcastMode>(mode));
+        });
+        setup_Action(broadcastModes[mode].first, action, nullptr, nullptr, nullptr, menu_Broadcast);
+        addAction(action);
+    }
+    connect(consoleTabulator, &TabWidget::broadcastModeChanged, broadcastGroup, [broadcastGroup](TabWidget::BroadcastMode mode) {
+        broadcastGroup->actions().at(mode)->setChecked(true);
+    });
+    menu_Broadcast->addSeparator();
+    setup_Action(BROADCAST_TOGGLE_TERMINAL, new QAction(tr("Add/Remove &Current Terminal"), settingOwner),
+                 nullptr, consoleTabulator, SLOT(toggleBroadcastSelection()), menu_Broadcast);
+    menu_Actions->addMenu(menu_Broadcast);
+
 
     menu_Actions->addSeparator();
 
@@ -343,27 +421,12 @@ void MainWindow::setup_ActionsMenu_Actions()
     setup_Action(FIND, new QAction(QIcon::fromTheme(QStringLiteral("edit-find")), tr("&Find..."), settingOwner),
                  FIND_SHORTCUT, this, SLOT(find()), menu_Actions);
 
+    setup_Action(FIND_ALL, new QAction(QIcon::fromTheme(QStringLiteral("edit-find")), tr("Find in &All Terminals..."), settingOwner),
+                 nullptr, this, SLOT(findAll()), menu_Actions);
+
     setup_Action(HANDLE_HISTORY, new QAction(QIcon::fromTheme(QStringLiteral("handle-history")), tr("Handle history..."), settingOwner),
                  NULL, this, SLOT(handleHistory()), menu_Actions);
 
-#if 0
-    act = new QAction(this);
-    act->setSeparator(true);
-
-    // TODO/FIXME: unimplemented for now
-    act = new QAction(tr("&Save Session"), this);
-    // do not use sequences for this task - it collides with eg. mc shortcuts
-    // and mainly - it's not used too often
-    //act->setShortcut(QKeySequence::Save);
-    connect(act, SIGNAL(triggered()), consoleTabulator, SLOT(saveSession()));
-
-    act = new QAction(tr("&Load Session"), this);
-    // do not use sequences for this task - it collides with eg. mc shortcuts
-    // and mainly - it's not used too often
-    //act->setShortcut(QKeySequence::Open);
-    connect(act, SIGNAL(triggered()), consoleTabulator, SLOT(loadSession()));
-#endif
-
     setup_Action(TOGGLE_MENU, new QAction(tr("&Toggle Menu"), settingOwner),
                  TOGGLE_MENU_SHORTCUT, this, SLOT(toggleMenu()));
     // this is correct - add action to main window - not to menu to keep toggle working
@@ -405,6 +468,14 @@ void MainWindow::setup_FileMenu_Actions()
 
     menu_File->addSeparator();
 
+    setup_Action(SAVE_SESSION, new QAction(QIcon::fromTheme(QStringLiteral("document-save")), tr("&Save Session..."), settingOwner),
+                 nullptr, this, SLOT(saveSession()), menu_File);
+
+    setup_Action(LOAD_SESSION, new QAction(QIcon::fromTheme(QStringLiteral("document-open")), tr("&Load Session..."), settingOwner),
+                 nullptr, this, SLOT(loadSession()), menu_File);
+
+    menu_File->addSeparator();
+
     setup_Action(PREFERENCES, new QAction(tr("&Preferences..."), settingOwner), "", this, SLOT(actProperties_triggered()), menu_File);
 
     menu_File->addSeparator();
@@ -618,6 +689,10 @@ void MainWindow::toggleBookmarks()
 
 bool MainWindow::closePrompt(const QString &title, const QString &text)
 {
+    // nobody could answer
+    if (QTerminalApp::Instance()->isHeadless())
+        return true;
+
     QDialog * dia = new QDialog(this);
     dia->setObjectName(QStringLiteral("exitDialog"));
     dia->setWindowTitle(title);
@@ -670,8 +745,12 @@ void MainWindow::closeEvent(QCloseEvent *ev)
                 Properties::Instance()->mainWindowState = saveState();
             }
         }
-        rebuildActions(); // shortcuts may have changed by another running instance
-        Properties::Instance()->saveSettings();
+        // a headless instance leaves the settings of the user alone
+        if (!QTerminalApp::Instance()->isHeadless())
+        {
+            rebuildActions(); // shortcuts may have changed by another running instance
+            Properties::Instance()->saveSettings();
+        }
         for (int i = consoleTabulator->count(); i > 0; --i)
         {
             consoleTabulator->removeTab(i - 1);
@@ -839,6 +918,16 @@ void MainWindow::find()
     consoleTabulator->terminalHolder()->currentTerminal()->impl()->toggleShowSearchBar();
 }
 
+void MainWindow::findAll()
+{
+    m_findAllDock->show();
+    if (m_findAllDock->isFloating())
+    {
+        m_findAllDock->activateWindow();
+    }
+    m_findAllWidget->focusSearch();
+}
+
 void MainWindow::handleHistory()
 {
     const QString dir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
@@ -926,12 +1015,60 @@ void MainWindow::showEvent(QShowEvent* event)
     QMainWindow::showEvent(event);
 }
 
+QVariantMap MainWindow::session() const
+{
+    QVariantMap window;
+    window[QStringLiteral("geometry")] = saveGeometry();
+    window[QStringLiteral("currentTab")] = consoleTabulator->currentIndex();
+    window[QStringLiteral("tabs")] = consoleTabulator->session();
+    return window;
+}
+
+void MainWindow::restoreSession(const QVariantMap &window)
+{
+    if (!m_dropMode)
+        restoreGeometry(window.value(QStringLiteral("geometry")).toByteArray());
+    consoleTabulator->restoreSession(window.value(QStringLiteral("tabs")).toList(),
+                                     window.value(QStringLiteral("currentTab")).toInt());
+}
+
+void MainWindow::saveSession()
+{
+    const SessionStore store = QTerminalApp::Instance()->sessionStore();
+    bool ok = false;
+    const QString name = QInputDialog::getItem(this, tr("Save Session"), tr("Session name:"),
+                                               store.names(), 0, true, &ok);
+    if (!ok || name.isEmpty())
+        return;
+    if (!store.save(name, QTerminalApp::Instance()->workspace()))
+        QMessageBox::warning(this, tr("Save Session"), tr("The session could not be saved."));
+}
+
+void MainWindow::loadSession()
+{
+    const SessionStore store = QTerminalApp::Instance()->sessionStore();
+    const QStringList names = store.names();
+    if (names.isEmpty())
+    {
+        QMessageBox::information(this, tr("Load Session"), tr("There are no saved sessions."));
+        return;
+    }
+
+    bool ok = false;
+    const QString name = QInputDialog::getItem(this, tr("Load Session"), tr("List of saved sessions:"),
+                                               names, 0, false, &ok);
+    if (!ok || name.isEmpty())
+        return;
+    if (!QTerminalApp::Instance()->restoreWorkspace(store.load(name)))
+        QMessageBox::warning(this, tr("Load Session"), tr("The session could not be loaded."));
+}
+
 void MainWindow::newTerminalWindow()
 {
     TerminalConfig cfg;
     TermWidgetHolder *ch = consoleTabulator->terminalHolder();
     if (ch)
-        cfg.provideCurrentDirectory(ch->currentTerminal()->impl()->workingDirectory());
+        cfg.provideCurrentDirectory(ch->currentTerminal()->workingDirectory());
 
     if (m_dropMode)
     { // the dropdown process has only one (dropdown) main window
@@ -1003,18 +1140,27 @@ void MainWindow::onCurrentTitleChanged(int index)
         title = consoleTabulator->tabText(index);
         icon = consoleTabulator->tabIcon(index);
     }
-    setWindowTitle(title.isEmpty() || !Properties::Instance()->changeWindowTitle ? QStringLiteral("QTerminal") : title);
-    setWindowIcon(icon.isNull() || !Properties::Instance()->changeWindowIcon ? QIcon::fromTheme(QStringLiteral("utilities-terminal")) : icon);
+    // both are a round-trip to the window manager, so only apply changes
+    const QString newTitle = title.isEmpty() || !Properties::Instance()->changeWindowTitle ? QStringLiteral("QTerminal") : title;
+    if (newTitle != windowTitle())
+        setWindowTitle(newTitle);
+
+    const bool useTabIcon = !icon.isNull() && Properties::Instance()->changeWindowIcon;
+    if (useTabIcon ? icon.cacheKey() != windowIcon().cacheKey()
+                   : windowIcon().name() != QLatin1String("utilities-terminal"))
+    {
+        setWindowIcon(useTabIcon ? icon : QIcon::fromTheme(QStringLiteral("utilities-terminal")));
+    }
 }
 
 bool MainWindow::hasMultipleTabs(QAction *)
 {
-    return consoleTabulator->findChildren<TermWidgetHolder*>().count() > 1;
+    return m_enabledTabCount > 1;
 }
 
 bool MainWindow::hasMultipleSubterminals(QAction *)
 {
-    return consoleTabulator->terminalHolder()->findChildren<TermWidget*>().count() > 1;
+    return m_enabledTerminalCount > 1;
 }
 
 bool MainWindow::hasIndexedTab(QAction *action)
@@ -1023,11 +1169,21 @@ bool MainWindow::hasIndexedTab(QAction *action)
     const int index = action->property("tab").toInt(&ok);
     Q_ASSERT(ok);
     static_cast<void>(ok);
-    return consoleTabulator->findChildren<TermWidgetHolder*>().count() >= index;
+    return m_enabledTabCount >= index;
 }
 
 void MainWindow::updateDisabledActions()
 {
+    // The predicates only depend on these counts, so there is nothing to do
+    // unless one of them changed.
+    const TermWidgetHolder *holder = consoleTabulator->terminalHolder();
+    const int tabCount = consoleTabulator->count();
+    const int terminalCount = holder ? holder->terminalCount() : 0;
+    if (tabCount == m_enabledTabCount && terminalCount == m_enabledTerminalCount)
+        return;
+    m_enabledTabCount = tabCount;
+    m_enabledTerminalCount = terminalCount;
+
     std::function<void(const QList<QAction *> &)> enableActions = [this, &enableActions](const QList<QAction *> &actions) {
         for (QAction *action : actions) {
             if (!action->data().isNull()) {
@@ -1070,9 +1226,168 @@ QDBusObjectPath MainWindow::newTab(const QHash<QString,QVariant> &termArgs)
     return qobject_cast<TermWidgetHolder*>(consoleTabulator->widget(idx))->getDbusPath();
 }
 
+int MainWindow::closeOtherTabs()
+{
+    return consoleTabulator->closeOtherTabs(consoleTabulator->currentIndex());
+}
+
+int MainWindow::closeTabsToRight()
+{
+    return consoleTabulator->closeTabsToRight(consoleTabulator->currentIndex());
+}
+
+int MainWindow::closeIdleTabs()
+{
+    return consoleTabulator->closeIdleTabs();
+}
+
+void MainWindow::sortTabs(const QString &key)
+{
+    if (key == QLatin1String("title"))
+        consoleTabulator->sortTabs(TabWidget::SortByTitle);
+    else if (key == QLatin1String("directory"))
+        consoleTabulator->sortTabs(TabWidget::SortByDirectory);
+    else if (key == QLatin1String("activity"))
+        consoleTabulator->sortTabs(TabWidget::SortByActivity);
+    else if (calledFromDBus())
+        sendErrorReply(QDBusError::InvalidArgs,
+                       QStringLiteral("unknown sort key \"%1\", expected title, directory or activity").arg(key));
+}
+
 void MainWindow::closeWindow()
 {
     close();
 }
 
+// the ids given to the panes of a layout, in the order of the terminals of the tab
+static void collectPaneIds(const QVariantMap &node, QStringList &ids)
+{
+    if (node.contains(QStringLiteral("terminal")))
+    {
+        ids.append(node.value(QStringLiteral("terminal")).toMap().value(QStringLiteral("id")).toString());
+        return;
+    }
+    const QVariantList children = node.value(QStringLiteral("children")).toList();
+    for (const QVariant &child : children)
+        collectPaneIds(child.toMap(), ids);
+}
+
+// adds the ids given to the panes of a layout to \a ids, which must not have them yet
+static bool addPaneIds(const QVariantMap &node, const QString &path, QSet<QString> &ids, QString *error)
+{
+    if (node.contains(QStringLiteral("terminal")))
+    {
+        const QString id = node.value(QStringLiteral("terminal")).toMap().value(QStringLiteral("id")).toString();
+        if (id.isEmpty())
+            return true;
+        if (ids.contains(id))
+        {
+            if (error)
+                *error = QStringLiteral("pane at %1: duplicate id \"%2\"").arg(path, id);
+            return false;
+        }
+        ids.insert(id);
+        return true;
+    }
+    const QVariantList children = node.value(QStringLiteral("children")).toList();
+    for (int i = 0; i < children.size(); ++i)
+    {
+        const QString childPath = (path.isEmpty() ? QString() : path + QLatin1Char('/'))
+                                  + QStringLiteral("children/%1").arg(i);
+        if (!addPaneIds(children.at(i).toMap(), childPath, ids, error))
+            return false;
+    }
+    return true;
+}
+
+bool MainWindow::layoutTabs(const QVariantMap &window, QVariantList &tabs, QString *error, QSet<QString> *paneIds)
+{
+    QSet<QString> ownIds;
+    QSet<QString> &ids = paneIds != nullptr ? *paneIds : ownIds;
+    const QVariantList described = window.value(QStringLiteral("tabs")).toList();
+    for (int i = 0; i < described.size(); ++i)
+    {
+        QVariantMap tab = described.at(i).toMap();
+        QVariantMap layout = tab.value(QStringLiteral("layout")).toMap();
+        if (layout.isEmpty())
+            layout[QStringLiteral("terminal")] = QVariantMap();
+        // a tab of a single pane needs no split around it
+        if (layout.contains(QStringLiteral("terminal")))
+            tab[QStringLiteral("layout")] = QVariantMap{{QStringLiteral("children"), QVariantList{layout}}};
+        QString why;
+        if (!SplitTree::isValid(tab.value(QStringLiteral("layout")), true, &why)
+            || !addPaneIds(tab.value(QStringLiteral("layout")).toMap(), QString(), ids, &why))
+        {
+            if (error)
+                *error = QStringLiteral("tab %1: %2").arg(i).arg(why);
+            return false;
+        }
+        tabs.append(tab);
+    }
+    return true;
+}
+
+QVariantMap MainWindow::applyLayout(const QVariantMap &layout, bool replaceFirst)
+{
+    QVariantMap result;
+    const QVariantMap window = fromDbusVariant(layout).toMap();
+    QVariantList tabs;
+    QString error;
+    if (!layoutTabs(window, tabs, &error))
+    {
+        if (calledFromDBus())
+            sendErrorReply(QDBusError::InvalidArgs, QStringLiteral("invalid layout, %1").arg(error));
+        return result;
+    }
+
+    const QList<TermWidgetHolder*> holders = consoleTabulator->addTabs(tabs, replaceFirst);
+    QList<QDBusObjectPath> tabPaths;
+    QList<QDBusObjectPath> terminalPaths;
+    QVariantMap panes;
+    for (int i = 0; i < holders.size(); ++i)
+    {
+        tabPaths.append(holders.at(i)->getDbusPath());
+        QStringList ids;
+        collectPaneIds(tabs.at(i).toMap().value(QStringLiteral("layout")).toMap(), ids);
+        const QList<TermWidget*> terminals = holders.at(i)->terminals();
+        for (int j = 0; j < terminals.size(); ++j)
+        {
+            terminalPaths.append(terminals.at(j)->getDbusPath());
+            if (!ids.value(j).isEmpty())
+                panes[ids.at(j)] = QVariant::fromValue(terminals.at(j)->getDbusPath());
+        }
+    }
+
+    const int current = window.value(QStringLiteral("current"), -1).toInt();
+    if (current >= 0 && current < holders.size())
+        consoleTabulator->setCurrentWidget(holders.at(current));
+
+    result[QStringLiteral("window")] = QVariant::fromValue(getDbusPath());
+    result[QStringLiteral("tabs")] = QVariant::fromValue(tabPaths);
+    result[QStringLiteral("terminals")] = QVariant::fromValue(terminalPaths);
+    result[QStringLiteral("panes")] = panes;
+    return result;
+}
+
+QVariantMap MainWindow::describe()
+{
+    QVariantList tabs;
+    for (int i = 0; i < consoleTabulator->count(); ++i)
+    {
+        TermWidgetHolder *holder = qobject_cast<TermWidgetHolder*>(consoleTabulator->widget(i));
+        QVariantMap tab = holder->describe();
+        tab[QStringLiteral("title")] = consoleTabulator->tabText(i);
+        tabs.append(tab);
+    }
+
+    QVariantMap info;
+    info[QStringLiteral("path")] = QVariant::fromValue(getDbusPath());
+    info[QStringLiteral("title")] = windowTitle();
+    info[QStringLiteral("active")] = isActiveWindow();
+    info[QStringLiteral("dropMode")] = m_dropMode;
+    info[QStringLiteral("currentTab")] = consoleTabulator->currentIndex();
+    info[QStringLiteral("tabs")] = tabs;
+    return info;
+}
+
 #endif
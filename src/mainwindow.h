@@ -23,6 +23,7 @@
 
 #include <QMainWindow>
 #include <QAction>
+#include <QSet>
 
 #include "qxtglobalshortcut.h"
 #include "terminalconfig.h"
@@ -33,8 +34,12 @@ namespace LayerShellQt {
 }
 
 class QToolButton;
+class FindAllWidget;
 
 class MainWindow : public QMainWindow, private Ui::mainWindow, public DBusAddressable
+#ifdef HAVE_QDBUS
+    , protected QDBusContext
+#endif
 {
     Q_OBJECT
 
@@ -45,17 +50,43 @@ public:
     ~MainWindow() override;
 
     bool dropMode() { return m_dropMode; }
+    TabWidget *tabWidget() { return consoleTabulator; }
     QMap<QString, QAction*> & leaseActions();
 
     void rebuildActions();
 
     bool closePrompt(const QString &title, const QString &text);
 
+    // geometry and tabs, as saved in a session
+    QVariantMap session() const;
+    void restoreSession(const QVariantMap &window);
+
     #ifdef HAVE_QDBUS
     QDBusObjectPath getActiveTab();
     QList<QDBusObjectPath> getTabs();
     QDBusObjectPath newTab(const QHash<QString,QVariant> &termArgs);
+    int closeOtherTabs();
+    int closeTabsToRight();
+    int closeIdleTabs();
+    void sortTabs(const QString &key);
     void closeWindow();
+
+    /*! Builds the tabs of a window description in one pass:
+        {"tabs": [{"title": s, "layout": split tree}], "current": i}.
+        The split tree is that of a session; its panes are
+        {"terminal": {"workingDirectory": s, "shell": as, "title": s, "id": s}}.
+        Returns the paths of the window, tabs and terminals, and of the
+        panes by id; an invalid layout is answered with InvalidArgs.
+     */
+    QVariantMap applyLayout(const QVariantMap &layout, bool replaceFirst = false);
+    /*! The tabs of a description, single panes wrapped in a split. Returns
+        false at the first invalid tab, which \a error then names. Pane ids
+        must be unique, also among those already in \a paneIds.
+     */
+    static bool layoutTabs(const QVariantMap &window, QVariantList &tabs, QString *error = nullptr,
+                           QSet<QString> *paneIds = nullptr);
+    // path, state and tabs, for QTerminalApp::describeAll()
+    QVariantMap describe();
     #endif
 
 protected:
@@ -74,6 +105,8 @@ private:
     TerminalConfig m_config;
 
     QDockWidget *m_bookmarksDock;
+    QDockWidget *m_findAllDock;
+    FindAllWidget *m_findAllWidget;
 
     void setup_Action(const char *name, QAction *action, const char *defaultShortcut, const QObject *receiver,
                       const char *slot, QMenu *menu = nullptr, const QVariant &data = QVariant());
@@ -93,13 +126,23 @@ private:
     QToolButton *m_dropLockButton;
     bool m_dropMode;
     LayerShellQt::Window *m_layerWindow;
-    QxtGlobalShortcut m_dropShortcut;
+    QxtGlobalShortcut *m_dropShortcut;
     void realign();
     void setDropShortcut(const QKeySequence& dropShortCut);
 
     bool hasMultipleTabs(QAction *);
     bool hasMultipleSubterminals(QAction *);
     bool hasIndexedTab(QAction *action);
+    // the counts the enabled state of the actions was computed for
+    int m_enabledTabCount;
+    int m_enabledTerminalCount;
+
+#ifdef HAVE_QDBUS
+signals:
+    // relayed by the D-Bus adaptor
+    void tabOpened(const QDBusObjectPath &tab);
+    void tabClosed(const QDBusObjectPath &tab);
+#endif
 
 public slots:
     void showHide();
@@ -119,8 +162,11 @@ private slots:
     void showFullscreen(bool fullscreen);
     void setKeepOpen(bool value);
     void find();
+    void findAll();
 
     void newTerminalWindow();
+    void saveSession();
+    void loadSession();
     void bookmarksWidget_callCommand(const QString&);
     void bookmarksDock_visibilityChanged(bool visible);
 
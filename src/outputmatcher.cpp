@@ -0,0 +1,89 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by LXQt team                                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include "outputmatcher.h"
+
+OutputMatcher::OutputMatcher(int capacity)
+    : m_capacity(qMax(capacity, 1))
+    , m_state(Text)
+    , m_decoder(QStringDecoder::Utf8)
+{
+}
+
+void OutputMatcher::append(QByteArrayView data)
+{
+    // escape sequences are plain ASCII, so they can be taken out before decoding
+    QByteArray plain;
+    plain.reserve(data.size());
+    for (const char c : data)
+    {
+        const uchar byte = static_cast<uchar>(c);
+        switch (m_state)
+        {
+        case Text:
+            if (byte == 0x1b)
+                m_state = Escape;
+            else if (byte >= 0x20 || byte == '\n' || byte == '\t')
+                plain.append(c);
+            break;
+        case Escape:
+            if (byte == '[')
+                m_state = Csi;
+            // OSC, DCS, APC, PM and SOS run to a string terminator
+            else if (byte == ']' || byte == 'P' || byte == '_' || byte == '^' || byte == 'X')
+                m_state = String;
+            else if (byte == '(' || byte == ')' || byte == '*' || byte == '+')
+                m_state = Charset;
+            else
+                m_state = Text;
+            break;
+        case Csi:
+            if (byte >= 0x40 && byte <= 0x7e)
+                m_state = Text;
+            break;
+        case String:
+            if (byte == 0x07)
+                m_state = Text;
+            else if (byte == 0x1b)
+                m_state = StringEscape;
+            break;
+        case StringEscape:
+            m_state = byte == '\\' ? Text : String;
+            break;
+        case Charset:
+            m_state = Text;
+            break;
+        }
+    }
+    if (plain.isEmpty())
+        return;
+
+    m_text += m_decoder.decode(plain);
+    if (m_text.size() > m_capacity)
+        m_text.remove(0, m_text.size() - m_capacity);
+}
+
+bool OutputMatcher::match(const QRegularExpression &pattern, QString *matched)
+{
+    const QRegularExpressionMatch found = pattern.match(m_text);
+    if (!found.hasMatch())
+        return false;
+    if (matched != nullptr)
+        *matched = found.captured(0);
+    m_text.remove(0, found.capturedEnd(0));
+    return true;
+}
@@ -0,0 +1,57 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by LXQt team                                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#ifndef OUTPUTMATCHER_H
+#define OUTPUTMATCHER_H
+
+#include <QByteArrayView>
+#include <QRegularExpression>
+#include <QString>
+#include <QStringDecoder>
+
+/*! \brief Recent output of a terminal as plain text, for matching patterns.
+
+append() takes the raw output as it arrives, drops escape sequences and
+control characters other than newlines and tabs, also when they are split
+between chunks, and decodes the rest as UTF-8. Only the last \a capacity
+characters are kept.
+
+A successful match() consumes the text up to the end of the match, so the
+next pattern is only matched against what came after it.
+*/
+class OutputMatcher
+{
+public:
+    static constexpr int DefaultCapacity = 64 * 1024;
+
+    explicit OutputMatcher(int capacity = DefaultCapacity);
+
+    void append(QByteArrayView data);
+    bool match(const QRegularExpression &pattern, QString *matched = nullptr);
+
+    const QString &text() const { return m_text; }
+
+private:
+    enum State { Text, Escape, Csi, String, StringEscape, Charset };
+
+    int m_capacity;
+    State m_state;
+    QStringDecoder m_decoder;
+    QString m_text;
+};
+
+#endif
@@ -0,0 +1,81 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by LXQt team                                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include "outputmeter.h"
+
+#include <algorithm>
+
+void OutputMeter::sample(qint64 now)
+{
+    const qint64 bytes = m_pendingBytes.exchange(0, std::memory_order_relaxed);
+    const qint64 counted = m_pendingCountedBytes.exchange(0, std::memory_order_relaxed);
+    qint64 lines = m_pendingLines.exchange(0, std::memory_order_relaxed);
+    // the uncounted bytes have as many lines as the counted ones
+    if (counted > 0 && bytes > counted)
+        lines += (bytes - counted) * lines / counted;
+
+    // the first sample is assumed to cover one second
+    qint64 interval = m_lastSample > 0 ? now - m_lastSample : 1000;
+    if (interval <= 0)
+        interval = 1000;
+    m_lastSample = now;
+
+    m_bytesPerSecond = bytes * 1000.0 / interval;
+    m_linesPerSecond = lines * 1000.0 / interval;
+    m_totalBytes += bytes;
+    m_totalLines += lines;
+    if (bytes > 0)
+        m_lastOutput = now;
+
+    m_samples[m_next] = bytes;
+    m_next = (m_next + 1) % SampleCount;
+    m_count = std::min(m_count + 1, SampleCount);
+}
+
+qint64 OutputMeter::msecsSinceOutput(qint64 now) const
+{
+    return m_lastOutput > 0 ? now - m_lastOutput : -1;
+}
+
+QList<qint64> OutputMeter::history() const
+{
+    QList<qint64> list;
+    list.reserve(m_count);
+    const int first = (m_next - m_count + SampleCount) % SampleCount;
+    for (int i = 0; i < m_count; ++i)
+        list.append(m_samples[(first + i) % SampleCount]);
+    return list;
+}
+
+QString OutputMeter::sparkline() const
+{
+    static const char16_t blocks[] = u"\u2581\u2582\u2583\u2584\u2585\u2586\u2587\u2588";
+
+    const QList<qint64> values = history();
+    const qint64 max = values.isEmpty() ? 0 : *std::max_element(values.cbegin(), values.cend());
+    QString line;
+    line.reserve(values.size());
+    for (const qint64 value : values)
+    {
+        // silence stays blank, any output gets at least the lowest block
+        if (value == 0 || max == 0)
+            line += QLatin1Char(' ');
+        else
+            line += QChar(blocks[value * 7 / max]);
+    }
+    return line;
+}
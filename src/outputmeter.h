@@ -0,0 +1,91 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by LXQt team                                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#ifndef OUTPUTMETER_H
+#define OUTPUTMETER_H
+
+#include <QList>
+#include <QString>
+
+#include <array>
+#include <atomic>
+
+/*! \brief Output rate of a terminal.
+
+add() is called for every chunk of output and only does relaxed atomic
+additions. The lines of a chunk are counted only while countsLines() says
+so, for the first LineSampleBytes of every sample; the lines of the rest
+are extrapolated from those by sample(). sample() is called periodically
+(once a second by TabWidget) and moves the pending counts into a small
+ring buffer, from which the rates, the time of the last output and a
+sparkline are derived.
+*/
+class OutputMeter
+{
+public:
+    static constexpr int SampleCount = 60;
+    static constexpr qint64 LineSampleBytes = 4096;
+
+    bool countsLines() const
+    {
+        return m_pendingCountedBytes.load(std::memory_order_relaxed) < LineSampleBytes;
+    }
+    // a chunk whose lines have been counted
+    void add(qint64 bytes, qint64 lines)
+    {
+        m_pendingBytes.fetch_add(bytes, std::memory_order_relaxed);
+        m_pendingCountedBytes.fetch_add(bytes, std::memory_order_relaxed);
+        m_pendingLines.fetch_add(lines, std::memory_order_relaxed);
+    }
+    void add(qint64 bytes)
+    {
+        m_pendingBytes.fetch_add(bytes, std::memory_order_relaxed);
+    }
+
+    void sample(qint64 now);
+
+    qint64 totalBytes() const { return m_totalBytes; }
+    // estimated when the output is faster than LineSampleBytes a sample
+    qint64 totalLines() const { return m_totalLines; }
+    double bytesPerSecond() const { return m_bytesPerSecond; }
+    double linesPerSecond() const { return m_linesPerSecond; }
+    // msecs since epoch of the last sample that saw output, 0 if none did
+    qint64 lastOutput() const { return m_lastOutput; }
+    qint64 msecsSinceOutput(qint64 now) const;
+
+    // bytes per sample, oldest first
+    QList<qint64> history() const;
+    QString sparkline() const;
+
+private:
+    std::atomic<qint64> m_pendingBytes{0};
+    std::atomic<qint64> m_pendingCountedBytes{0};
+    std::atomic<qint64> m_pendingLines{0};
+
+    qint64 m_totalBytes = 0;
+    qint64 m_totalLines = 0;
+    double m_bytesPerSecond = 0;
+    double m_linesPerSecond = 0;
+    qint64 m_lastSample = 0;
+    qint64 m_lastOutput = 0;
+
+    std::array<qint64, SampleCount> m_samples{};
+    int m_next = 0;
+    int m_count = 0;
+};
+
+#endif
@@ -0,0 +1,147 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by LXQt team                                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include <QSocketNotifier>
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "outputtap.h"
+
+OutputTap::OutputTap(int fd, bool timestamps, int bufferSize, QObject *parent)
+    : QObject(parent)
+    , m_fd(fd)
+    , m_timestamps(timestamps)
+    , m_writeNotifier(new QSocketNotifier(fd, QSocketNotifier::Write, this))
+    , m_readNotifier(new QSocketNotifier(fd, QSocketNotifier::Read, this))
+    , m_ring(qMax(bufferSize, 1), Qt::Uninitialized)
+    , m_head(0)
+    , m_used(0)
+    , m_dropped(0)
+    , m_droppedTotal(0)
+{
+    ::fcntl(m_fd, F_SETFL, ::fcntl(m_fd, F_GETFL) | O_NONBLOCK);
+    m_writeNotifier->setEnabled(false);
+    connect(m_writeNotifier, &QSocketNotifier::activated, this, &OutputTap::flush);
+    // the reader never writes, readable means it has gone
+    connect(m_readNotifier, &QSocketNotifier::activated, this, &OutputTap::checkPeer);
+}
+
+OutputTap::~OutputTap()
+{
+    close();
+}
+
+void OutputTap::write(const QByteArray &data, qint64 msecs)
+{
+    if (m_fd < 0 || data.isEmpty())
+        return;
+
+    QByteArray header;
+    if (m_timestamps)
+        header = QByteArrayLiteral("T ") + QByteArray::number(msecs) + ' ' + QByteArray::number(data.size()) + '\n';
+    QByteArray loss;
+    if (m_timestamps && m_dropped > 0)
+        loss = QByteArrayLiteral("L ") + QByteArray::number(msecs) + ' ' + QByteArray::number(m_dropped) + '\n';
+
+    // a chunk is taken whole or not at all, so frames stay intact
+    const qsizetype needed = loss.size() + header.size() + data.size();
+    if (needed > m_ring.size() - m_used)
+    {
+        m_dropped += data.size();
+        m_droppedTotal += data.size();
+        return;
+    }
+
+    enqueue(loss.constData(), loss.size());
+    m_dropped = 0;
+    enqueue(header.constData(), header.size());
+    enqueue(data.constData(), data.size());
+    flush();
+}
+
+void OutputTap::enqueue(const char *data, int size)
+{
+    if (size == 0)
+        return;
+    const int capacity = m_ring.size();
+    int offset = 0;
+    // nothing waits for the reader: try to hand it over without buffering
+    if (m_used == 0)
+    {
+        const ssize_t sent = ::send(m_fd, data, size, MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (sent > 0)
+            offset = static_cast<int>(sent);
+    }
+    const int rest = size - offset;
+    const int tail = (m_head + m_used) % capacity;
+    const int first = qMin(rest, capacity - tail);
+    std::memcpy(m_ring.data() + tail, data + offset, first);
+    std::memcpy(m_ring.data(), data + offset + first, rest - first);
+    m_used += rest;
+}
+
+void OutputTap::flush()
+{
+    while (m_fd >= 0 && m_used > 0)
+    {
+        const int capacity = m_ring.size();
+        const int chunk = qMin(m_used, capacity - m_head);
+        const ssize_t sent = ::send(m_fd, m_ring.constData() + m_head, chunk, MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (sent < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+                break;
+            close();
+            emit closed();
+            return;
+        }
+        m_head = (m_head + static_cast<int>(sent)) % capacity;
+        m_used -= static_cast<int>(sent);
+    }
+    if (m_used == 0)
+        m_head = 0;
+    if (m_fd >= 0)
+        m_writeNotifier->setEnabled(m_used > 0);
+}
+
+void OutputTap::checkPeer()
+{
+    char buffer[256];
+    const ssize_t count = ::recv(m_fd, buffer, sizeof(buffer), MSG_DONTWAIT);
+    if (count > 0 || (count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)))
+        return;
+    close();
+    emit closed();
+}
+
+void OutputTap::close()
+{
+    if (m_fd < 0)
+        return;
+    // the notifiers must not watch a closed descriptor
+    m_writeNotifier->setEnabled(false);
+    m_readNotifier->setEnabled(false);
+    ::close(m_fd);
+    m_fd = -1;
+    m_used = 0;
+}
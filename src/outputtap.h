@@ -0,0 +1,80 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by LXQt team                                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#ifndef OUTPUTTAP_H
+#define OUTPUTTAP_H
+
+#include <QByteArray>
+#include <QObject>
+
+class QSocketNotifier;
+
+/*! \brief A copy of the output of a terminal, written to a socket.
+
+Output is sent to the socket as it arrives; only what the reader has not
+taken yet is kept, in a ring buffer of fixed size. When a chunk does not
+fit into it, the chunk is dropped and counted instead of blocking the
+terminal or growing the buffer.
+
+With timestamps, the stream is framed: every chunk is preceded by a line
+"T <msecs since epoch> <length>", and dropped output is reported by a line
+"L <msecs since epoch> <length>" before the next chunk that fits. Without
+them the raw bytes are written and the loss is only counted, see
+droppedBytes().
+
+The tap closes itself when the reader goes away.
+*/
+class OutputTap : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int DefaultBufferSize = 256 * 1024;
+
+    // takes over \a fd, a connected stream socket
+    OutputTap(int fd, bool timestamps, int bufferSize = DefaultBufferSize, QObject *parent = nullptr);
+    ~OutputTap() override;
+
+    void write(const QByteArray &data, qint64 msecs);
+
+    bool isOpen() const { return m_fd >= 0; }
+    qint64 droppedBytes() const { return m_droppedTotal; }
+    int buffered() const { return m_used; }
+
+signals:
+    void closed();
+
+private:
+    void enqueue(const char *data, int size);
+    void flush();
+    void checkPeer();
+    void close();
+
+    int m_fd;
+    bool m_timestamps;
+    QSocketNotifier *m_writeNotifier;
+    QSocketNotifier *m_readNotifier;
+
+    QByteArray m_ring;
+    int m_head;
+    int m_used;
+    // dropped since the last loss report
+    qint64 m_dropped;
+    qint64 m_droppedTotal;
+};
+
+#endif
@@ -0,0 +1,148 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by LXQt team                                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+
+#include <QObject>
+
+#include "paneindex.h"
+
+#include <algorithm>
+#include <cassert>
+#include <climits>
+#include <cstdlib>
+
+typedef struct  {
+    QPoint topLeft;
+    QPoint middle;
+    QPoint bottomRight;
+} NavigationData;
+
+static void transpose(QPoint *point) {
+    int x = point->x();
+    point->setX(point->y());
+    point->setY(x);
+}
+
+static void transposeTransform(NavigationData *point) {
+    transpose(&point->topLeft);
+    transpose(&point->middle);
+    transpose(&point->bottomRight);
+}
+
+static void flipTransform(NavigationData *point) {
+    QPoint oldTopLeft = point->topLeft;
+    point->topLeft = -(point->bottomRight);
+    point->bottomRight = -(oldTopLeft);
+    point->middle = -(point->middle);
+}
+
+static void normalizeToRight(NavigationData *point, NavigationDirection dir) {
+    switch (dir) {
+        case Left:
+            flipTransform(point);
+            break;
+        case Right:
+            // No-op
+            break;
+        case Top:
+            flipTransform(point);
+            transposeTransform(point);
+            break;
+        case Bottom:
+            transposeTransform(point);
+            break;
+        default:
+            assert("Invalid navigation");
+            return;
+    }
+}
+
+static NavigationData getNormalizedDimensions(const QRect &r, NavigationDirection dir) {
+    NavigationData nd;
+    nd.topLeft = r.topLeft();
+    nd.middle = r.topLeft() + QPoint(r.width() / 2, r.height() / 2);
+    nd.bottomRight = r.topLeft() + QPoint(r.width(), r.height());
+    normalizeToRight(&nd, dir);
+    return nd;
+}
+
+void PaneIndex::rebuild(const QList<Pane> &panes)
+{
+    m_panes = panes;
+    m_neighbours.clear();
+    m_neighbours.reserve(m_panes.size());
+
+    // Quadratic, but only once per layout change instead of on every keypress.
+    for (const Pane &from : std::as_const(m_panes))
+    {
+        std::array<QObject*, 4> &neighbours = m_neighbours[from.pane];
+        for (int d = Left; d <= Bottom; ++d)
+        {
+            const NavigationDirection dir = static_cast<NavigationDirection>(d);
+            const NavigationData fromDims = getNormalizedDimensions(from.rect, dir);
+
+            // Point of interest: the middle of the edge we are leaving through.
+            const QPoint poi = QPoint(fromDims.bottomRight.x(), fromDims.middle.y());
+
+            // Only "Right navigation" implementation is necessary -- other cases
+            // are normalized to this one. Prefer, in order, lower x() and lower
+            // distance between poi.y() and the corners.
+            int lowestX = INT_MAX;
+            int lowestMidpointDistance = INT_MAX;
+            QObject *fittest = nullptr;
+            for (const Pane &contender : std::as_const(m_panes))
+            {
+                const NavigationData contenderDims = getNormalizedDimensions(contender.rect, dir);
+                if (contenderDims.topLeft.x() <= poi.x())
+                    continue;
+                const int midpointDistance = std::min(
+                    abs(poi.y() - contenderDims.topLeft.y()),
+                    abs(poi.y() - contenderDims.bottomRight.y())
+                );
+                if (contenderDims.topLeft.x() > lowestX)
+                    continue;
+                if (midpointDistance > lowestMidpointDistance)
+                    continue;
+                lowestX = contenderDims.topLeft.x();
+                lowestMidpointDistance = midpointDistance;
+                fittest = contender.pane;
+            }
+            neighbours[d] = fittest;
+        }
+    }
+    m_valid = true;
+}
+
+void PaneIndex::invalidate()
+{
+    m_panes.clear();
+    m_neighbours.clear();
+    m_valid = false;
+}
+
+QObject *PaneIndex::first() const
+{
+    return m_panes.isEmpty() ? nullptr : m_panes.first().pane;
+}
+
+QObject *PaneIndex::neighbour(const QObject *pane, NavigationDirection dir) const
+{
+    const auto it = m_neighbours.constFind(pane);
+    if (it == m_neighbours.constEnd())
+        return nullptr;
+    return (*it)[dir];
+}
@@ -0,0 +1,68 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by LXQt team                                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+
+#ifndef PANEINDEX_H
+#define PANEINDEX_H
+
+#include <QHash>
+#include <QList>
+#include <QRect>
+
+#include <array>
+
+class QObject;
+
+typedef enum NavigationDirection {
+    Left,
+    Right,
+    Top,
+    Bottom
+} NavigationDirection;
+
+/*! \brief Geometry of the panes (terminals) of a tab.
+
+Holds the rectangle of every pane and, computed once per layout, its nearest
+neighbour in each direction, so that directional navigation is a lookup.
+TermWidgetHolder invalidates it whenever a pane is moved, resized, added or
+removed and rebuilds it on the next navigation.
+*/
+class PaneIndex
+{
+public:
+    struct Pane {
+        QObject *pane;
+        QRect rect;
+    };
+
+    void rebuild(const QList<Pane> &panes);
+    void invalidate();
+    bool isValid() const { return m_valid; }
+
+    int count() const { return static_cast<int>(m_panes.size()); }
+    QObject *first() const;
+    bool contains(const QObject *pane) const { return m_neighbours.contains(pane); }
+    // nullptr if there is no pane in that direction
+    QObject *neighbour(const QObject *pane, NavigationDirection dir) const;
+
+private:
+    QList<Pane> m_panes;
+    QHash<const QObject*, std::array<QObject*, 4>> m_neighbours;
+    bool m_valid = false;
+};
+
+#endif
@@ -16,6 +16,7 @@
  *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
  ***************************************************************************/
 
+#include <QRegularExpression>
 #include <qtermwidget.h>
 #include <cassert>
 
@@ -84,6 +85,7 @@ void Properties::loadSettings()
 
     highlightCurrentTerminal = m_settings->value(QLatin1String("highlightCurrentTerminal"), true).toBool();
     focusOnMoueOver = m_settings->value(QLatin1String("focusOnMoueOver"), false).toBool();
+    showResizeOverlay = m_settings->value(QLatin1String("ShowResizeOverlay"), true).toBool();
     showTerminalSizeHint = m_settings->value(QLatin1String("showTerminalSizeHint"), true).toBool();
 
     font = QFont(qvariant_cast<QString>(m_settings->value(QLatin1String("fontFamily"), defaultFont().family())),
@@ -101,18 +103,6 @@ void Properties::loadSettings()
 
     emulation = m_settings->value(QLatin1String("emulation"), QLatin1String("default")).toString();
 
-    // sessions
-    int size = m_settings->beginReadArray(QLatin1String("Sessions"));
-    for (int i = 0; i < size; ++i)
-    {
-        m_settings->setArrayIndex(i);
-        QString name(m_settings->value(QLatin1String("name")).toString());
-        if (name.isEmpty())
-            continue;
-        sessions[name] = m_settings->value(QLatin1String("state")).toString();
-    }
-    m_settings->endArray();
-
     terminalMargin = m_settings->value(QLatin1String("TerminalMargin"), 0).toInt();
 
     termTransparency = m_settings->value(QLatin1String("TerminalTransparency"), 0).toInt();
@@ -193,6 +183,10 @@ void Properties::loadSettings()
         mouseAutoHideDelay = -1; // disable (no zero delay)
     }
 
+    hibernateIdleTabsAfter = m_settings->value(QLatin1String("HibernateIdleTabsAfter"), 0).toInt();
+    silenceSeconds = m_settings->value(QLatin1String("SilenceSeconds"), 10).toInt();
+    dbusSignalInterval = m_settings->value(QLatin1String("DBusSignalInterval"), 250).toInt();
+
     prefDialogSize = m_settings->value(QLatin1String("PrefDialogSize")).toSize();
 }
 
@@ -202,6 +196,7 @@ void Properties::saveSettings()
     m_settings->setValue(QLatin1String("colorScheme"), colorScheme);
     m_settings->setValue(QLatin1String("highlightCurrentTerminal"), highlightCurrentTerminal);
     m_settings->setValue(QLatin1String("focusOnMoueOver"), focusOnMoueOver);
+    m_settings->setValue(QLatin1String("ShowResizeOverlay"), showResizeOverlay);
     m_settings->setValue(QLatin1String("showTerminalSizeHint"), showTerminalSizeHint);
     m_settings->setValue(QLatin1String("fontFamily"), font.family());
     m_settings->setValue(QLatin1String("fontSize"), font.pointSize());
@@ -234,19 +229,8 @@ void Properties::saveSettings()
 
     m_settings->setValue(QLatin1String("emulation"), emulation);
 
-    // sessions
-    m_settings->beginWriteArray(QLatin1String("Sessions"));
-    int i = 0;
-    Sessions::iterator sit = sessions.begin();
-    while (sit != sessions.end())
-    {
-        m_settings->setArrayIndex(i);
-        m_settings->setValue(QLatin1String("name"), sit.key());
-        m_settings->setValue(QLatin1String("state"), sit.value());
-        ++sit;
-        ++i;
-    }
-    m_settings->endArray();
+    // sessions live in their own store, see SessionStore
+    m_settings->remove(QLatin1String("Sessions"));
 
     m_settings->setValue(QLatin1String("TerminalMargin"), terminalMargin);
     m_settings->setValue(QLatin1String("TerminalTransparency"), termTransparency);
@@ -318,6 +302,10 @@ void Properties::saveSettings()
     }
     m_settings->setValue(QLatin1String("MouseAutoHideDelay"), autoDelay);
 
+    m_settings->setValue(QLatin1String("HibernateIdleTabsAfter"), hibernateIdleTabsAfter);
+    m_settings->setValue(QLatin1String("SilenceSeconds"), silenceSeconds);
+    m_settings->setValue(QLatin1String("DBusSignalInterval"), dbusSignalInterval);
+
     m_settings->setValue(QLatin1String("PrefDialogSize"), prefDialogSize);
 
     // the config file may be created now
@@ -24,10 +24,6 @@
 #include <QFont>
 #include <QFileSystemWatcher>
 
-typedef QString Session;
-
-typedef QMap<QString,Session> Sessions;
-
 typedef QMap<QString,QString> ShortcutMap;
 
 
@@ -59,6 +55,7 @@ class Properties
         QString guiStyle;
         bool highlightCurrentTerminal;
         bool focusOnMoueOver;
+        bool showResizeOverlay;
         bool showTerminalSizeHint;
 
         bool historyLimited;
@@ -66,8 +63,6 @@ class Properties
 
         QString emulation;
 
-        Sessions sessions;
-
         int terminalMargin;
         int termTransparency;
         QString backgroundImage;
@@ -134,6 +129,10 @@ class Properties
         int mouseAutoHideDelay;
 
         bool useFontBoxDrawingChars;
+
+        int hibernateIdleTabsAfter; // minutes, 0 means never
+        int silenceSeconds; // 0 means never
+        int dbusSignalInterval; // msecs between state signals of a terminal, 0 means no limit
     private:
 
         Properties(const Properties &) = delete;
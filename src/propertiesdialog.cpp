@@ -221,6 +221,10 @@ PropertiesDialog::PropertiesDialog(QWidget *parent)
     }
     mouseAutoHideSpinBox->setValue(autoDelay);
 
+    hibernateSpinBox->setValue(Properties::Instance()->hibernateIdleTabsAfter);
+    silenceSpinBox->setValue(Properties::Instance()->silenceSeconds);
+    dbusIntervalSpinBox->setValue(Properties::Instance()->dbusSignalInterval);
+
     // Setting windows style actions
     styleComboBox->addItem(tr("System Default"));
     styleComboBox->addItems(QStyleFactory::keys());
@@ -238,6 +242,7 @@ PropertiesDialog::PropertiesDialog(QWidget *parent)
     highlightCurrentCheckBox->setChecked(Properties::Instance()->highlightCurrentTerminal);
 
     focusOnMoueOverCheckBox->setChecked(Properties::Instance()->focusOnMoueOver);
+    resizeOverlayCheckBox->setChecked(Properties::Instance()->showResizeOverlay);
 
     showTerminalSizeHintCheckBox->setChecked(Properties::Instance()->showTerminalSizeHint);
 
@@ -348,6 +353,7 @@ void PropertiesDialog::apply()
     Properties::Instance()->termTransparency = termTransparencyBox->value();
     Properties::Instance()->highlightCurrentTerminal = highlightCurrentCheckBox->isChecked();
     Properties::Instance()->focusOnMoueOver = focusOnMoueOverCheckBox->isChecked();
+    Properties::Instance()->showResizeOverlay = resizeOverlayCheckBox->isChecked();
     Properties::Instance()->showTerminalSizeHint = showTerminalSizeHintCheckBox->isChecked();
     Properties::Instance()->backgroundImage = backgroundImageLineEdit->text();
     Properties::Instance()->backgroundMode = qBound(0, backgroundModecomboBox->currentIndex(), 4);
@@ -422,6 +428,10 @@ void PropertiesDialog::apply()
     }
     Properties::Instance()->mouseAutoHideDelay = autoDelay;
 
+    Properties::Instance()->hibernateIdleTabsAfter = hibernateSpinBox->value();
+    Properties::Instance()->silenceSeconds = silenceSpinBox->value();
+    Properties::Instance()->dbusSignalInterval = dbusIntervalSpinBox->value();
+
     saveBookmarksFile();
     // NOTE: Because the path of the bookmarks file may be changed by saveBookmarksFile(),
     // it should be saved only after that.
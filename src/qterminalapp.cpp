@@ -0,0 +1,336 @@
+/***************************************************************************
+ *   Copyright (C) 2006 by Vladimir Kuznetsov                              *
+ *   vovanec@gmail.com                                                     *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include <cassert>
+#include <cstdio>
+#include <unistd.h>
+#include <utility>
+
+#ifdef HAVE_QDBUS
+    #include <QtDBus/QtDBus>
+    #include "processadaptor.h"
+    #include "commandrunner.h"
+#endif
+
+#include "mainwindow.h"
+#include "properties.h"
+#include "qterminalapp.h"
+
+static const char* serviceName = "org.lxqt.QTerminal";
+static const char* ifaceName = "org.lxqt.QTerminal.Process";
+
+QTerminalApp * QTerminalApp::m_instance = nullptr;
+
+MainWindow *QTerminalApp::newWindow(bool dropMode, TerminalConfig &cfg, const QVariantMap &session)
+{
+    MainWindow *window = nullptr;
+    if (dropMode)
+    {
+        window = new MainWindow(cfg, dropMode);
+        if (!session.isEmpty())
+            window->restoreSession(session);
+        if (Properties::Instance()->dropShowOnStart)
+            window->show();
+    }
+    else
+    {
+        window = new MainWindow(cfg, dropMode);
+        // restored before showing, so that only the visible terminals start
+        if (!session.isEmpty())
+        {
+            window->restoreSession(session);
+        }
+        else if (Properties::Instance()->saveSizeOnExit
+                 && Properties::Instance()->windowMaximized
+                 && !m_headless)
+        {
+            window->setWindowState(Qt::WindowMaximized);
+        }
+        // Shown for the layout and the sizes of the terminals, but never
+        // exposed, so nothing is painted unless a screenshot is taken.
+        if (m_headless)
+            window->setAttribute(Qt::WA_DontShowOnScreen);
+        window->show();
+    }
+    return window;
+}
+
+SessionStore QTerminalApp::sessionStore() const
+{
+    return SessionStore(Properties::Instance()->configDir() + QStringLiteral("/sessions"));
+}
+
+QVariantMap QTerminalApp::workspace() const
+{
+    QVariantList windows;
+    for (MainWindow *window : m_windowList)
+    {
+        if (!window->dropMode())
+            windows.append(window->session());
+    }
+    QVariantMap workspace;
+    workspace[QStringLiteral("windows")] = windows;
+    return workspace;
+}
+
+bool QTerminalApp::restoreWorkspace(const QVariantMap &workspace)
+{
+    const QVariantList windows = workspace.value(QStringLiteral("windows")).toList();
+    for (const QVariant &window : windows)
+    {
+        // the first tab is replaced by the session before its shell starts
+        TerminalConfig cfg;
+        cfg.setLazy(true);
+        newWindow(false, cfg, window.toMap());
+    }
+    return !windows.isEmpty();
+}
+
+QTerminalApp *QTerminalApp::Instance()
+{
+    assert(m_instance != nullptr);
+    return m_instance;
+}
+
+QTerminalApp *QTerminalApp::Instance(int &argc, char **argv)
+{
+    assert(m_instance == nullptr);
+    m_instance = new QTerminalApp(argc, argv);
+    return m_instance;
+}
+
+QTerminalApp::QTerminalApp(int &argc, char **argv)
+    :QApplication(argc, argv)
+{
+}
+
+QString &QTerminalApp::getWorkingDirectory()
+{
+    return m_workDir;
+}
+
+void QTerminalApp::setWorkingDirectory(const QString &wd)
+{
+    m_workDir = wd;
+}
+
+void QTerminalApp::cleanup() {
+    delete m_instance;
+    m_instance = nullptr;
+}
+
+
+void QTerminalApp::addWindow(MainWindow *window)
+{
+    m_windowList.append(window);
+    #ifdef HAVE_QDBUS
+    emit windowOpened(window->getDbusPath());
+    #endif
+}
+
+void QTerminalApp::removeWindow(MainWindow *window)
+{
+    m_windowList.removeOne(window);
+    #ifdef HAVE_QDBUS
+    emit windowClosed(window->getDbusPath());
+    #endif
+}
+
+QList<MainWindow *> QTerminalApp::getWindowList()
+{
+    return m_windowList;
+}
+
+#ifdef HAVE_QDBUS
+void QTerminalApp::registerOnDbus(bool dropDown)
+{
+    // also serves the control socket, which works without a bus
+    new ProcessAdaptor(this);
+
+    if (!QDBusConnection::sessionBus().isConnected())
+    {
+        fprintf(stderr, "Cannot connect to the D-Bus session bus.\n"
+                "To start it, run:\n"
+                "\teval `dbus-launch --auto-syntax`\n");
+        return;
+    }
+
+    if (dropDown)
+    {
+        if (!QDBusConnection::sessionBus().registerService(QLatin1String(serviceName)))
+        {
+            m_isPrimaryInstance = false;
+            return;
+        }
+        QDBusConnection::sessionBus().registerObject(QStringLiteral("/"), this);
+    }
+    else
+    {
+        if (!QDBusConnection::sessionBus().registerService(QLatin1String(serviceName)
+                                                           + QStringLiteral("-%1").arg(getpid())))
+        {
+            fprintf(stderr, "%s\n", qPrintable(QDBusConnection::sessionBus().lastError().message()));
+            return;
+        }
+        QDBusConnection::sessionBus().registerObject(QStringLiteral("/"), this);
+    }
+}
+
+QList<QDBusObjectPath> QTerminalApp::getWindows()
+{
+    QList<QDBusObjectPath> windows;
+    for (MainWindow *wnd : std::as_const(m_windowList))
+    {
+        windows.push_back(wnd->getDbusPath());
+    }
+    return windows;
+}
+
+QDBusObjectPath QTerminalApp::newWindow(const QHash<QString,QVariant> &termArgs)
+{
+    TerminalConfig cfg = TerminalConfig::fromDbus(termArgs);
+    MainWindow *wnd = newWindow(false, cfg);
+    assert(wnd != nullptr);
+    return wnd->getDbusPath();
+}
+
+QVariantMap QTerminalApp::applyLayout(const QVariantMap &layout)
+{
+    QVariantMap result;
+    const QVariantList windows = fromDbusVariant(layout).toMap().value(QStringLiteral("windows")).toList();
+    if (windows.isEmpty())
+    {
+        if (calledFromDBus())
+            sendErrorReply(QDBusError::InvalidArgs, QStringLiteral("invalid layout, no windows"));
+        return result;
+    }
+    // no window is opened unless all of them can be
+    QSet<QString> paneIds;
+    for (int i = 0; i < windows.size(); ++i)
+    {
+        QVariantList tabs;
+        QString error;
+        if (!MainWindow::layoutTabs(windows.at(i).toMap(), tabs, &error, &paneIds))
+            error = QStringLiteral("window %1, %2").arg(i).arg(error);
+        else if (tabs.isEmpty())
+            error = QStringLiteral("window %1 has no tabs").arg(i);
+        else
+            continue;
+        if (calledFromDBus())
+            sendErrorReply(QDBusError::InvalidArgs, QStringLiteral("invalid layout, %1").arg(error));
+        return result;
+    }
+
+    QList<QDBusObjectPath> windowPaths;
+    QList<QDBusObjectPath> tabs;
+    QList<QDBusObjectPath> terminals;
+    QVariantMap panes;
+    for (const QVariant &window : windows)
+    {
+        // the placeholder tab is replaced before the window is shown
+        TerminalConfig cfg;
+        cfg.setLazy(true);
+        MainWindow *wnd = new MainWindow(cfg, false);
+        const QVariantMap built = wnd->applyLayout(window.toMap(), true);
+        wnd->show();
+
+        windowPaths.append(wnd->getDbusPath());
+        tabs.append(built.value(QStringLiteral("tabs")).value<QList<QDBusObjectPath>>());
+        terminals.append(built.value(QStringLiteral("terminals")).value<QList<QDBusObjectPath>>());
+        panes.insert(built.value(QStringLiteral("panes")).toMap());
+    }
+
+    result[QStringLiteral("windows")] = QVariant::fromValue(windowPaths);
+    result[QStringLiteral("tabs")] = QVariant::fromValue(tabs);
+    result[QStringLiteral("terminals")] = QVariant::fromValue(terminals);
+    result[QStringLiteral("panes")] = panes;
+    return result;
+}
+
+QVariantMap QTerminalApp::describeAll()
+{
+    QVariantList windows;
+    for (MainWindow *wnd : std::as_const(m_windowList))
+        windows.append(wnd->describe());
+
+    QVariantMap tree;
+    tree[QStringLiteral("windows")] = windows;
+    return tree;
+}
+
+int QTerminalApp::runCommand(const QStringList &command, const QVariantMap &options)
+{
+    if (m_commands == nullptr)
+    {
+        m_commands = new CommandRunner(this);
+        connect(m_commands, &CommandRunner::started, this, &QTerminalApp::commandStarted);
+        connect(m_commands, &CommandRunner::finished, this, &QTerminalApp::commandFinished);
+    }
+    return m_commands->run(command, options);
+}
+
+QVariantMap QTerminalApp::getCommands()
+{
+    QVariantMap result;
+    result[QStringLiteral("commands")] = m_commands != nullptr ? m_commands->commands() : QVariantList();
+    return result;
+}
+
+QDBusObjectPath QTerminalApp::getActiveWindow()
+{
+    QWidget *aw = activeWindow();
+    if (aw == nullptr)
+        return QDBusObjectPath("/");
+    return qobject_cast<MainWindow*>(aw)->getDbusPath();
+}
+
+bool QTerminalApp::isDropMode() {
+  if (m_windowList.count() == 0) {
+    return false;
+  }
+  MainWindow *wnd = m_windowList.at(0);
+  return wnd->dropMode();
+}
+
+bool QTerminalApp::toggleDropdown() {
+  if (m_windowList.count() == 0) {
+    return false;
+  }
+  MainWindow *wnd = m_windowList.at(0);
+  if (!wnd->dropMode()) {
+    return false;
+  }
+  wnd->showHide();
+  return true;
+}
+
+void QTerminalApp::requestDropDown()
+{
+    QDBusInterface iface(QLatin1String(serviceName),
+                         QStringLiteral("/"),
+                         QLatin1String(ifaceName), QDBusConnection::sessionBus(), this);
+    iface.call(QStringLiteral("toggleDropdown"));
+}
+
+bool QTerminalApp::isPrimaryInstance() {
+  return m_isPrimaryInstance;
+}
+
+
+#endif
+
@@ -8,14 +8,19 @@
 
 
 #include "mainwindow.h"
+#include "sessionstore.h"
 
+class CommandRunner;
 
 class QTerminalApp : public QApplication
+#ifdef HAVE_QDBUS
+    , protected QDBusContext
+#endif
 {
 Q_OBJECT
 
 public:
-    MainWindow *newWindow(bool dropMode, TerminalConfig &cfg);
+    MainWindow *newWindow(bool dropMode, TerminalConfig &cfg, const QVariantMap &session = QVariantMap());
     QList<MainWindow*> getWindowList();
     void addWindow(MainWindow *window);
     void removeWindow(MainWindow *window);
@@ -24,10 +29,34 @@ public:
     QString &getWorkingDirectory();
     void setWorkingDirectory(const QString &wd);
 
+    // no display: windows are never exposed and nobody answers prompts
+    void setHeadless(bool headless) { m_headless = headless; }
+    bool isHeadless() const { return m_headless; }
+
+    SessionStore sessionStore() const;
+    // all windows except the dropdown one
+    QVariantMap workspace() const;
+    bool restoreWorkspace(const QVariantMap &workspace);
+
     #ifdef HAVE_QDBUS
     void registerOnDbus(bool dropDown);
     QList<QDBusObjectPath> getWindows();
     QDBusObjectPath newWindow(const QHash<QString,QVariant> &termArgs);
+    /*! MainWindow::applyLayout() for {"windows": [...]}, each a new window.
+        Nothing is opened unless every window is valid.
+     */
+    QVariantMap applyLayout(const QVariantMap &layout);
+    /*! All windows with their tabs and terminals, and what scripts
+        would otherwise ask every terminal for, in one call.
+     */
+    QVariantMap describeAll();
+    /*! Runs \a command in a new terminal, see CommandRunner for the
+        options. Returns the id that commandFinished() reports, -1 if
+        nothing can be run.
+     */
+    int runCommand(const QStringList &command, const QVariantMap &options);
+    // {"commands": [...]}, those queued, running and recently finished
+    QVariantMap getCommands();
     QDBusObjectPath getActiveWindow();
     bool isDropMode();
     bool toggleDropdown();
@@ -37,11 +66,24 @@ public:
 
     static void cleanup();
 
+#ifdef HAVE_QDBUS
+signals:
+    // relayed by the D-Bus adaptor
+    void windowOpened(const QDBusObjectPath &window);
+    void windowClosed(const QDBusObjectPath &window);
+    void commandStarted(int id, const QDBusObjectPath &terminal);
+    void commandFinished(int id, int exitStatus, qint64 runtime);
+#endif
+
 private:
     QString m_workDir;
     QList<MainWindow *> m_windowList;
     static QTerminalApp *m_instance;
     bool m_isPrimaryInstance = true;
+    bool m_headless = false;
+    #ifdef HAVE_QDBUS
+    CommandRunner *m_commands = nullptr;
+    #endif
     QTerminalApp(int &argc, char **argv);
     ~QTerminalApp() override{};
 };
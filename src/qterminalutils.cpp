@@ -15,6 +15,7 @@
  *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
  ***************************************************************************/
 
+#include <QFile>
 #include <QRegularExpression>
 
 #include "qterminalutils.h"
@@ -62,3 +63,89 @@ QStringList parse_command(const QString& str)
     return list;
 }
 
+
+static bool is_word_start(const QString& text, int i)
+{
+    if (i == 0)
+        return true;
+    const QChar prev = text.at(i - 1);
+    if (prev.isSpace() || prev.isPunct() || prev.isSymbol())
+        return true;
+    return prev.isLower() && text.at(i).isUpper();
+}
+
+int fuzzy_match(const QString& pattern, const QString& text)
+{
+    int score = 0;
+    int p = 0;
+    int last = -2;
+    for (int i = 0; i < text.size() && p < pattern.size(); ++i)
+    {
+        if (text.at(i).toCaseFolded() != pattern.at(p).toCaseFolded())
+            continue;
+        score += 1;
+        if (i == last + 1)
+            score += 5;
+        if (is_word_start(text, i))
+            score += 10;
+        last = i;
+        ++p;
+    }
+    return p < pattern.size() ? -1 : score;
+}
+
+QString process_name(int pid)
+{
+#ifdef Q_OS_LINUX
+    QFile comm(QStringLiteral("/proc/%1/comm").arg(pid));
+    if (pid > 0 && comm.open(QIODevice::ReadOnly))
+        return QString::fromLocal8Bit(comm.readAll()).trimmed();
+#else
+    Q_UNUSED(pid);
+#endif
+    return QString();
+}
+
+int char_width(char32_t ucs)
+{
+    const QChar::Category category = QChar::category(ucs);
+    if (ucs < 0x20 || category == QChar::Mark_NonSpacing || category == QChar::Mark_Enclosing
+        || category == QChar::Other_Format)
+        return 0;
+    // East Asian wide and fullwidth characters, and emoji
+    if ((ucs >= 0x1100 && ucs <= 0x115f) || (ucs >= 0x2e80 && ucs <= 0xa4cf && ucs != 0x303f)
+        || (ucs >= 0xac00 && ucs <= 0xd7a3) || (ucs >= 0xf900 && ucs <= 0xfaff)
+        || (ucs >= 0xfe30 && ucs <= 0xfe4f) || (ucs >= 0xff00 && ucs <= 0xff60)
+        || (ucs >= 0xffe0 && ucs <= 0xffe6) || (ucs >= 0x1f300 && ucs <= 0x1f64f)
+        || (ucs >= 0x1f900 && ucs <= 0x1f9ff) || (ucs >= 0x20000 && ucs <= 0x3fffd))
+        return 2;
+    return 1;
+}
+
+QList<qsizetype> wrap_line(QStringView line, int columns)
+{
+    QList<qsizetype> starts{0};
+    if (columns <= 0)
+        return starts;
+    int width = 0;
+    for (qsizetype i = 0; i < line.size();)
+    {
+        char32_t ucs = line.at(i).unicode();
+        qsizetype length = 1;
+        if (QChar::isHighSurrogate(ucs) && i + 1 < line.size() && line.at(i + 1).isLowSurrogate())
+        {
+            ucs = QChar::surrogateToUcs4(line.at(i), line.at(i + 1));
+            length = 2;
+        }
+        const int cells = char_width(ucs);
+        // a wide character does not fit into the last column either
+        if (width > 0 && width + cells > columns)
+        {
+            starts.append(i);
+            width = 0;
+        }
+        width += cells;
+        i += length;
+    }
+    return starts;
+}
@@ -18,9 +18,26 @@
 #ifndef QTERMINALUTILS_H
 #define QTERMINALUTILS_H
 
+#include <QList>
 #include <QString>
 #include <QStringList>
+#include <QStringView>
 
 QStringList parse_command(const QString& str);
 
+// Case-insensitive subsequence match of pattern in text. Returns -1 when
+// text does not contain all characters of pattern in order, otherwise a
+// score that favors consecutive characters and word starts.
+int fuzzy_match(const QString& pattern, const QString& text);
+
+// The command name of a process, empty where it cannot be found out.
+QString process_name(int pid);
+
+// The cells a character takes in the terminal: 0, 1, or 2 for wide ones.
+int char_width(char32_t ucs);
+
+// Where the rows of a line of text start when it wraps at \a columns, as
+// the terminal wraps it; the first one is always 0.
+QList<qsizetype> wrap_line(QStringView line, int columns);
+
 #endif
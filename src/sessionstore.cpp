@@ -0,0 +1,97 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by LXQt team                                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+
+#include <QCborMap>
+#include <QCborValue>
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+#include <QUrl>
+
+#include "sessionstore.h"
+
+static const QLatin1String FORMAT_KEY("format");
+static const QLatin1String VERSION_KEY("version");
+static const QLatin1String WORKSPACE_KEY("workspace");
+static const QLatin1String FORMAT("qterminal-session");
+static const QLatin1String SUFFIX(".session");
+
+SessionStore::SessionStore(const QString &directory)
+    : m_directory(directory)
+{
+}
+
+QString SessionStore::fileName(const QString &name) const
+{
+    // names are free text, keep them from escaping the directory
+    return QDir(m_directory).filePath(QString::fromLatin1(QUrl::toPercentEncoding(name)) + SUFFIX);
+}
+
+QStringList SessionStore::names() const
+{
+    QStringList names;
+    const QStringList files = QDir(m_directory).entryList({QStringLiteral("*") + SUFFIX}, QDir::Files, QDir::Name);
+    for (const QString &file : files)
+        names.append(QUrl::fromPercentEncoding(file.chopped(SUFFIX.size()).toLatin1()));
+    return names;
+}
+
+bool SessionStore::save(const QString &name, const QVariantMap &workspace) const
+{
+    if (name.isEmpty() || !QDir().mkpath(m_directory))
+        return false;
+
+    QSaveFile file(fileName(name));
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+    file.write(encode(workspace));
+    return file.commit();
+}
+
+QVariantMap SessionStore::load(const QString &name) const
+{
+    QFile file(fileName(name));
+    if (!file.open(QIODevice::ReadOnly))
+        return QVariantMap();
+    return decode(file.readAll());
+}
+
+bool SessionStore::remove(const QString &name) const
+{
+    return QFile::remove(fileName(name));
+}
+
+QByteArray SessionStore::encode(const QVariantMap &workspace)
+{
+    QCborMap map;
+    map[FORMAT_KEY] = FORMAT;
+    map[VERSION_KEY] = Version;
+    map[WORKSPACE_KEY] = QCborValue::fromVariant(workspace);
+    return map.toCborValue().toCbor();
+}
+
+QVariantMap SessionStore::decode(const QByteArray &data)
+{
+    const QCborMap map = QCborValue::fromCbor(data).toMap();
+    if (map.value(FORMAT_KEY).toString() != FORMAT)
+        return QVariantMap();
+    const qint64 version = map.value(VERSION_KEY).toInteger();
+    if (version < 1 || version > Version)
+        return QVariantMap();
+    return map.value(WORKSPACE_KEY).toMap().toVariantMap();
+}
@@ -0,0 +1,54 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by LXQt team                                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+
+#ifndef SESSIONSTORE_H
+#define SESSIONSTORE_H
+
+#include <QString>
+#include <QStringList>
+#include <QVariantMap>
+
+/*! \brief Saved workspaces (windows, tabs and their split layouts).
+
+Every session is a file in the given directory holding a CBOR map with a
+format tag, a version and the workspace itself. Files of an unknown format
+or of a newer version are treated as missing.
+*/
+class SessionStore
+{
+public:
+    static constexpr int Version = 1;
+
+    explicit SessionStore(const QString &directory);
+
+    QStringList names() const;
+    bool save(const QString &name, const QVariantMap &workspace) const;
+    // empty if there is no valid session of that name
+    QVariantMap load(const QString &name) const;
+    bool remove(const QString &name) const;
+
+    static QByteArray encode(const QVariantMap &workspace);
+    static QVariantMap decode(const QByteArray &data);
+
+private:
+    QString fileName(const QString &name) const;
+
+    QString m_directory;
+};
+
+#endif
@@ -0,0 +1,96 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by LXQt team                                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include <QTimer>
+
+#include "signalthrottle.h"
+
+SignalThrottle::SignalThrottle(QObject *parent)
+    : QObject(parent)
+    , m_interval(0)
+    , m_timer(new QTimer(this))
+{
+    m_clock.start();
+    m_timer->setSingleShot(true);
+    connect(m_timer, &QTimer::timeout, this, &SignalThrottle::flush);
+}
+
+void SignalThrottle::setInterval(int msecs)
+{
+    m_interval = qMax(0, msecs);
+    schedule();
+}
+
+void SignalThrottle::post(int kind, const std::function<void()> &emitter)
+{
+    Kind &k = m_kinds[kind];
+    const qint64 now = m_clock.elapsed();
+    if (k.lastEmitted < 0 || now - k.lastEmitted >= m_interval)
+    {
+        k.pending = nullptr;
+        k.lastEmitted = now;
+        emitter();
+        return;
+    }
+    k.pending = emitter;
+    if (!m_timer->isActive())
+        schedule();
+}
+
+bool SignalThrottle::isPending(int kind) const
+{
+    const auto it = m_kinds.constFind(kind);
+    return it != m_kinds.constEnd() && it->pending;
+}
+
+void SignalThrottle::flush()
+{
+    const qint64 now = m_clock.elapsed();
+    // collected first, an emitter may post again
+    QList<std::function<void()>> due;
+    for (auto it = m_kinds.begin(); it != m_kinds.end(); ++it)
+    {
+        if (it->pending && now - it->lastEmitted >= m_interval)
+        {
+            due.append(it->pending);
+            it->pending = nullptr;
+            it->lastEmitted = now;
+        }
+    }
+    for (const auto &emitter : std::as_const(due))
+        emitter();
+    schedule();
+}
+
+void SignalThrottle::schedule()
+{
+    // wake up for the pending change that is due first
+    qint64 next = -1;
+    const qint64 now = m_clock.elapsed();
+    for (auto it = m_kinds.cbegin(); it != m_kinds.cend(); ++it)
+    {
+        if (!it->pending)
+            continue;
+        const qint64 due = qMax<qint64>(0, it->lastEmitted + m_interval - now);
+        if (next < 0 || due < next)
+            next = due;
+    }
+    if (next < 0)
+        m_timer->stop();
+    else
+        m_timer->start(static_cast<int>(next));
+}
@@ -0,0 +1,65 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by LXQt team                                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#ifndef SIGNALTHROTTLE_H
+#define SIGNALTHROTTLE_H
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QObject>
+
+#include <functional>
+
+class QTimer;
+
+/*! \brief Rate limit for the change notifications of one object.
+
+post() runs the emitter of a kind of change right away if that kind was
+not emitted within the interval. Otherwise it is kept, replacing one that
+is still waiting, and runs when the interval is over. A burst of changes
+thus ends with the latest state, and each kind is emitted at most once per
+interval. An interval of 0 emits everything right away.
+*/
+class SignalThrottle : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit SignalThrottle(QObject *parent = nullptr);
+
+    void setInterval(int msecs);
+    int interval() const { return m_interval; }
+
+    void post(int kind, const std::function<void()> &emitter);
+    bool isPending(int kind) const;
+
+private:
+    struct Kind {
+        qint64 lastEmitted = -1;
+        std::function<void()> pending;
+    };
+
+    void flush();
+    void schedule();
+
+    int m_interval;
+    QElapsedTimer m_clock;
+    QTimer *m_timer;
+    QHash<int, Kind> m_kinds;
+};
+
+#endif
@@ -0,0 +1,302 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by LXQt team                                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+
+#include <QObject>
+
+#include "splittree.h"
+
+static const int SIZE_SCALE = 10000;
+
+static const QLatin1String ORIENTATION_KEY("orientation");
+static const QLatin1String CHILDREN_KEY("children");
+static const QLatin1String RATIO_KEY("ratio");
+static const QLatin1String TERMINAL_KEY("terminal");
+
+SplitTree::SplitTree()
+    : m_root(new Node)
+    , m_leafCount(0)
+{
+}
+
+SplitTree::~SplitTree()
+{
+    delete m_root;
+}
+
+void SplitTree::setObject(Node *node, QObject *object)
+{
+    m_nodes.remove(node->object);
+    node->object = object;
+    if (object != nullptr)
+        m_nodes.insert(object, node);
+}
+
+QList<QObject*> SplitTree::leaves() const
+{
+    QList<QObject*> objects;
+    objects.reserve(m_leafCount);
+    collect(m_root, true, objects);
+    return objects;
+}
+
+QList<QObject*> SplitTree::branches() const
+{
+    QList<QObject*> objects;
+    collect(m_root, false, objects);
+    return objects;
+}
+
+void SplitTree::collect(const Node *node, bool leaves, QList<QObject*> &objects) const
+{
+    // the root is part of the holder, not of the layout
+    if (node->leaf == leaves && node != m_root && node->object != nullptr)
+        objects.append(node->object);
+    for (const Node *child : node->children)
+        collect(child, leaves, objects);
+}
+
+QObject *SplitTree::firstLeaf(const Node *node) const
+{
+    while (node != nullptr && !node->leaf)
+        node = node->children.isEmpty() ? nullptr : node->children.first();
+    return node != nullptr ? node->object : nullptr;
+}
+
+SplitTree::Change SplitTree::append(QObject *leaf)
+{
+    Node *n = new Node;
+    n->leaf = true;
+    n->parent = m_root;
+    n->ratio = m_root->children.isEmpty() ? 1.0 : 1.0 / m_root->children.size();
+    m_root->children.append(n);
+    setObject(n, leaf);
+    ++m_leafCount;
+    normalize(m_root);
+
+    Change change;
+    change.branch = m_root;
+    return change;
+}
+
+SplitTree::Change SplitTree::split(QObject *leaf, Qt::Orientation orientation, QObject *newLeaf)
+{
+    Change change;
+    Node *l = node(leaf);
+    if (l == nullptr || !l->leaf)
+        return change;
+
+    Node *parent = l->parent;
+    Node *n = new Node;
+    n->leaf = true;
+    setObject(n, newLeaf);
+    ++m_leafCount;
+
+    // a branch with a single child can still choose its orientation
+    if (parent->children.size() == 1)
+        parent->orientation = orientation;
+
+    if (parent->orientation == orientation)
+    {
+        // split the share of the leaf among both
+        l->ratio /= 2;
+        n->ratio = l->ratio;
+        n->parent = parent;
+        parent->children.insert(parent->children.indexOf(l) + 1, n);
+    }
+    else
+    {
+        Node *b = new Node;
+        b->orientation = orientation;
+        b->parent = parent;
+        b->ratio = l->ratio;
+        parent->children[parent->children.indexOf(l)] = b;
+
+        l->parent = b;
+        l->ratio = 0.5;
+        n->parent = b;
+        n->ratio = 0.5;
+        b->children = {l, n};
+    }
+
+    change.branch = parent;
+    change.focus = newLeaf;
+    return change;
+}
+
+SplitTree::Change SplitTree::remove(QObject *leaf)
+{
+    Change change;
+    Node *l = node(leaf);
+    if (l == nullptr || !l->leaf)
+        return change;
+
+    Node *parent = l->parent;
+    parent->children.removeOne(l);
+    setObject(l, nullptr);
+    delete l;
+    --m_leafCount;
+    normalize(parent);
+
+    // collapse branches left with a single child, excluding the root
+    if (parent != m_root && parent->children.size() == 1)
+    {
+        Node *heir = parent->children.takeFirst();
+        Node *grandParent = parent->parent;
+        heir->parent = grandParent;
+        heir->ratio = parent->ratio;
+        grandParent->children[grandParent->children.indexOf(parent)] = heir;
+
+        change.dropped = parent->object;
+        setObject(parent, nullptr);
+        delete parent;
+
+        change.branch = grandParent;
+        change.focus = firstLeaf(heir);
+        return change;
+    }
+
+    change.branch = parent;
+    change.focus = firstLeaf(parent);
+    return change;
+}
+
+void SplitTree::normalize(Node *branch)
+{
+    double total = 0;
+    for (const Node *child : std::as_const(branch->children))
+        total += child->ratio;
+    if (total <= 0)
+        return;
+    for (Node *child : std::as_const(branch->children))
+        child->ratio /= total;
+}
+
+QList<int> SplitTree::sizes(const Node *branch) const
+{
+    QList<int> sizes;
+    sizes.reserve(branch->children.size());
+    for (const Node *child : branch->children)
+        sizes.append(qMax(1, qRound(child->ratio * SIZE_SCALE)));
+    return sizes;
+}
+
+void SplitTree::setSizes(Node *branch, const QList<int> &sizes)
+{
+    if (sizes.size() != branch->children.size())
+        return;
+    for (int i = 0; i < sizes.size(); ++i)
+        branch->children.at(i)->ratio = sizes.at(i);
+    normalize(branch);
+}
+
+QVariant SplitTree::toVariant(const std::function<QVariant(QObject*)> &leafData) const
+{
+    return nodeToVariant(m_root, leafData);
+}
+
+QVariant SplitTree::nodeToVariant(const Node *node, const std::function<QVariant(QObject*)> &leafData) const
+{
+    QVariantMap map;
+    map[RATIO_KEY] = node->ratio;
+    if (node->leaf)
+    {
+        map[TERMINAL_KEY] = leafData(node->object);
+        return map;
+    }
+
+    map[ORIENTATION_KEY] = node->orientation == Qt::Horizontal ? QStringLiteral("horizontal")
+                                                               : QStringLiteral("vertical");
+    QVariantList children;
+    for (const Node *child : node->children)
+        children.append(nodeToVariant(child, leafData));
+    map[CHILDREN_KEY] = children;
+    return map;
+}
+
+static bool validateNode(const QVariantMap &map, bool isRoot, const QString &path, QString *error)
+{
+    const auto fail = [&](const QString &why) {
+        if (error)
+            *error = path.isEmpty() ? why : QStringLiteral("pane at %1: %2").arg(path, why);
+        return false;
+    };
+    if (map.contains(TERMINAL_KEY))
+        return !isRoot || fail(QStringLiteral("the root must be a split"));
+
+    const QVariantList children = map.value(CHILDREN_KEY).toList();
+    // the root needs a terminal, other branches something to split
+    if (isRoot && children.isEmpty())
+        return fail(QStringLiteral("the root has no panes"));
+    if (!isRoot && children.size() < 2)
+        return fail(QStringLiteral("a split needs at least two children"));
+    for (int i = 0; i < children.size(); ++i)
+    {
+        const QString childPath = (path.isEmpty() ? QString() : path + QLatin1Char('/'))
+                                  + CHILDREN_KEY + QLatin1Char('/') + QString::number(i);
+        if (!validateNode(children.at(i).toMap(), false, childPath, error))
+            return false;
+    }
+    return true;
+}
+
+bool SplitTree::isValid(const QVariant &layout, bool isRoot, QString *error)
+{
+    return validateNode(layout.toMap(), isRoot, QString(), error);
+}
+
+bool SplitTree::fromVariant(const QVariant &layout, const std::function<QObject*(const QVariant&)> &makeLeaf)
+{
+    if (!isValid(layout, true))
+        return false;
+
+    qDeleteAll(m_root->children);
+    m_root->children.clear();
+    QObject *rootObject = m_root->object;
+    m_nodes.clear();
+    if (rootObject != nullptr)
+        m_nodes.insert(rootObject, m_root);
+    m_leafCount = 0;
+
+    buildNode(m_root, layout.toMap(), makeLeaf);
+    m_root->ratio = 1.0;
+    return true;
+}
+
+void SplitTree::buildNode(Node *node, const QVariantMap &map, const std::function<QObject*(const QVariant&)> &makeLeaf)
+{
+    node->ratio = map.value(RATIO_KEY, 1.0).toDouble();
+    if (map.contains(TERMINAL_KEY))
+    {
+        node->leaf = true;
+        setObject(node, makeLeaf(map.value(TERMINAL_KEY)));
+        ++m_leafCount;
+        return;
+    }
+
+    node->orientation = map.value(ORIENTATION_KEY).toString() == QLatin1String("vertical") ? Qt::Vertical
+                                                                                          : Qt::Horizontal;
+    const QVariantList children = map.value(CHILDREN_KEY).toList();
+    for (const QVariant &child : children)
+    {
+        Node *n = new Node;
+        n->parent = node;
+        node->children.append(n);
+        buildNode(n, child.toMap(), makeLeaf);
+    }
+    normalize(node);
+}
@@ -0,0 +1,110 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by LXQt team                                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+
+#ifndef SPLITTREE_H
+#define SPLITTREE_H
+
+#include <QHash>
+#include <QList>
+#include <QVariant>
+
+#include <functional>
+
+class QObject;
+
+/*! \brief The split layout of a tab.
+
+A tree whose leaves are terminals and whose inner nodes (branches) split
+their area along an orientation, each child taking a share (ratio) of it.
+The root is always a branch, even with a single child.
+
+TermWidgetHolder keeps the tree as the source of truth and derives the
+nested QSplitters from it: every branch carries the splitter that shows it
+in its object. The operations only touch the nodes on the way from a leaf
+to the root and report which branch has to be synced with the widgets.
+*/
+class SplitTree
+{
+public:
+    struct Node {
+        Node *parent = nullptr;
+        // the terminal of a leaf, the splitter showing a branch
+        QObject *object = nullptr;
+        bool leaf = false;
+        Qt::Orientation orientation = Qt::Horizontal;
+        // share of the parent along its orientation, the siblings sum up to 1
+        double ratio = 1.0;
+        QList<Node*> children;
+
+        ~Node() { qDeleteAll(children); }
+    };
+
+    struct Change {
+        // the branch whose children have to be synced with the widgets
+        Node *branch = nullptr;
+        // the object of a branch that was collapsed and has to be deleted
+        QObject *dropped = nullptr;
+        // the leaf that takes the place of a removed one
+        QObject *focus = nullptr;
+    };
+
+    SplitTree();
+    ~SplitTree();
+    SplitTree(const SplitTree&) = delete;
+    SplitTree &operator=(const SplitTree&) = delete;
+
+    Node *root() const { return m_root; }
+    Node *node(const QObject *object) const { return m_nodes.value(object); }
+    void setObject(Node *node, QObject *object);
+
+    int count() const { return m_leafCount; }
+    QList<QObject*> leaves() const;
+    // the objects of all branches but the root
+    QList<QObject*> branches() const;
+    QObject *firstLeaf(const Node *node) const;
+
+    Change append(QObject *leaf);
+    Change split(QObject *leaf, Qt::Orientation orientation, QObject *newLeaf);
+    Change remove(QObject *leaf);
+
+    // sizes for QSplitter::setSizes(), which scales them to the real space
+    QList<int> sizes(const Node *branch) const;
+    void setSizes(Node *branch, const QList<int> &sizes);
+
+    QVariant toVariant(const std::function<QVariant(QObject*)> &leafData) const;
+    /*! Replaces the whole tree; the old objects are left to the caller.
+        Returns false and leaves the tree untouched if \a layout is not valid.
+     */
+    bool fromVariant(const QVariant &layout, const std::function<QObject*(const QVariant&)> &makeLeaf);
+    /*! Whether fromVariant() would accept \a layout; if not, \a error names
+        the offending pane by its path of child indexes, e.g. "children/1/children/0".
+     */
+    static bool isValid(const QVariant &layout, bool isRoot = true, QString *error = nullptr);
+
+private:
+    void collect(const Node *node, bool leaves, QList<QObject*> &objects) const;
+    QVariant nodeToVariant(const Node *node, const std::function<QVariant(QObject*)> &leafData) const;
+    void buildNode(Node *node, const QVariantMap &map, const std::function<QObject*(const QVariant&)> &makeLeaf);
+    static void normalize(Node *branch);
+
+    Node *m_root;
+    QHash<const QObject*, Node*> m_nodes;
+    int m_leafCount;
+};
+
+#endif
@@ -1,27 +1,36 @@
 #include <QApplication>
+#include <QDir>
 #include <QKeyEvent>
-#include <QTimer>
+#include <QLabel>
 #include <QStyledItemDelegate>
 
 #include "tab-switcher.h"
 #include "tabwidget.h"
+#include "termwidgetholder.h"
+#include "qterminalutils.h"
 
 // -----------------------------------------------------------------------------------------------------------
 
 enum class AppRole {
     Display = Qt::DisplayRole,
-    Index   = Qt::UserRole +1
+    Index   = Qt::UserRole +1,
+    Title,
+    Cwd,
+    Process
 };
 
-// -----------------------------------------------------------------------------------------------------------
-
 AppModel::AppModel(QObject* parent, TabWidget* tabs):
-    QAbstractListModel(parent)
+    QAbstractListModel(parent),
+    m_tabs(tabs)
 {
-    for(QWidget* w: tabs->history()) {
-        int index = w->property("tab_index").toInt();
-        m_list.append({tabs->tabText(index), index});
-    }
+    for(QWidget* w: tabs->history())
+        updateTab(w);
+    for(int i = 0; i < tabs->count(); ++i)
+        updateTab(tabs->widget(i));
+
+    connect(tabs, &TabWidget::tabInfoChanged, this, &AppModel::updateTab);
+    connect(tabs, &TabWidget::tabClosed, this, &AppModel::removeTab);
+    connect(tabs, &QTabWidget::currentChanged, this, &AppModel::raiseTab);
 }
 
 int AppModel::rowCount(const QModelIndex& /*parent*/) const
@@ -34,16 +43,148 @@ QVariant AppModel::data(const QModelIndex &index, int role) const
     if (!index.isValid() || index.row() >= m_list.size())
         return QVariant();
 
+    const AppInfo& info = m_list[index.row()];
     switch(static_cast<AppRole>(role)) {
     case AppRole::Display:
-        return m_list[index.row()].name;
+        if (info.process.isEmpty() && info.cwd.isEmpty())
+            return info.name;
+        return QStringLiteral("%1  \u2014  %2").arg(info.name, QStringList{info.process, info.cwd}.join(QLatin1Char(' ')).trimmed());
     case AppRole::Index:
-        return m_list[index.row()].index;
+        return m_tabs->tabIndex(info.holder);
+    case AppRole::Title:
+        return info.name;
+    case AppRole::Cwd:
+        return info.cwd;
+    case AppRole::Process:
+        return info.process;
     }
 
     return {};
 }
 
+int AppModel::rowOf(const QWidget* holder) const
+{
+    for (int i = 0; i < m_list.size(); ++i)
+    {
+        if (m_list.at(i).holder == holder)
+            return i;
+    }
+    return -1;
+}
+
+void AppModel::updateTab(QWidget* holder)
+{
+    if (holder == nullptr)
+        return;
+
+    int tabIndex = m_tabs->tabIndex(holder);
+    if (tabIndex < 0)
+        tabIndex = m_tabs->indexOf(holder);
+
+    AppInfo info{holder, m_tabs->tabText(tabIndex), QString(), QString()};
+    if (TermWidgetHolder* console = qobject_cast<TermWidgetHolder*>(holder))
+    {
+        // qtermwidget has no signal for directory changes, but shells
+        // update the title with every prompt
+        if (TermWidget* term = console->currentTerminal())
+        {
+            QString cwd = term->workingDirectory();
+            const QString home = QDir::homePath();
+            if (cwd.startsWith(home))
+                cwd.replace(0, home.size(), QStringLiteral("~"));
+            info.cwd = cwd;
+            if (!term->isPending())
+                info.process = process_name(term->impl()->getForegroundProcessId());
+        }
+    }
+
+    const int row = rowOf(holder);
+    if (row < 0)
+    {
+        beginInsertRows(QModelIndex(), m_list.size(), m_list.size());
+        m_list.append(info);
+        endInsertRows();
+    }
+    else
+    {
+        m_list[row] = info;
+        emit dataChanged(index(row), index(row));
+    }
+}
+
+void AppModel::removeTab(QWidget* holder)
+{
+    const int row = rowOf(holder);
+    if (row < 0)
+        return;
+    beginRemoveRows(QModelIndex(), row, row);
+    m_list.removeAt(row);
+    endRemoveRows();
+}
+
+void AppModel::raiseTab(int tabIndex)
+{
+    QWidget* holder = m_tabs->widget(tabIndex);
+    int row = rowOf(holder);
+    if (row < 0)
+    {
+        updateTab(holder);
+        row = rowOf(holder);
+    }
+    if (row <= 0)
+        return;
+    beginMoveRows(QModelIndex(), row, row, QModelIndex(), 0);
+    m_list.move(row, 0);
+    endMoveRows();
+}
+
+// -----------------------------------------------------------------------------------------------------------
+
+AppFilterModel::AppFilterModel(QObject* parent):
+    QSortFilterProxyModel(parent)
+{
+}
+
+void AppFilterModel::setPattern(const QString& pattern)
+{
+    if (pattern == m_pattern)
+        return;
+    m_pattern = pattern;
+    invalidate();
+}
+
+int AppFilterModel::score(const QModelIndex& sourceIndex) const
+{
+    if (m_pattern.isEmpty())
+        return 0;
+
+    // prefer matches in the title over equal ones in the directory or process
+    int best = fuzzy_match(m_pattern, sourceIndex.data(static_cast<int>(AppRole::Title)).toString());
+    if (best > 0)
+        best *= 2;
+    best = qMax(best, fuzzy_match(m_pattern, sourceIndex.data(static_cast<int>(AppRole::Cwd)).toString()));
+    best = qMax(best, fuzzy_match(m_pattern, sourceIndex.data(static_cast<int>(AppRole::Process)).toString()));
+    return best;
+}
+
+bool AppFilterModel::filterAcceptsRow(int sourceRow, const QModelIndex& sourceParent) const
+{
+    return score(sourceModel()->index(sourceRow, 0, sourceParent)) >= 0;
+}
+
+bool AppFilterModel::lessThan(const QModelIndex& left, const QModelIndex& right) const
+{
+    if (!m_pattern.isEmpty())
+    {
+        const int l = score(left);
+        const int r = score(right);
+        if (l != r)
+            return l > r;
+    }
+    // most recently used first
+    return left.row() < right.row();
+}
+
 // -----------------------------------------------------------------------------------------------------------
 
 class AppItemDelegate: public QStyledItemDelegate
@@ -89,49 +230,61 @@ private:
 
 // -----------------------------------------------------------------------------------------------------------
 
+static QString typedText(const QKeyEvent *event)
+{
+    const QString text = event->text();
+    if (!text.isEmpty() && text.at(0).isPrint())
+        return text;
+    // while Ctrl is still held, text() is a control character
+    const int key = event->key();
+    if (key >= Qt::Key_A && key <= Qt::Key_Z)
+        return QString(QChar(u'a' + (key - Qt::Key_A)));
+    if (key >= Qt::Key_0 && key <= Qt::Key_9)
+        return QString(QChar(u'0' + (key - Qt::Key_0)));
+    return QString();
+}
+
 TabSwitcher::TabSwitcher(TabWidget *tabs)
     : QListView(tabs)
-    , m_timer(new QTimer(this))
     , m_tabs(tabs)
+    , m_filter(new AppFilterModel(this))
+    , m_patternLabel(new QLabel(this))
+    , m_filtering(false)
+    , m_accepted(true)
 {
     setWindowFlags(Qt::Widget | Qt::Popup | Qt::WindowStaysOnTopHint);
     setItemDelegate(new AppItemDelegate(frameWidth(), tabs));
     setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+    // only the visible rows are laid out, however many tabs there are
+    setUniformItemSizes(true);
 
-    m_timer->setInterval(100);
-    m_timer->setSingleShot(true);
+    m_filter->setSourceModel(new AppModel(m_filter, tabs));
+    m_filter->sort(0);
+    setModel(m_filter);
 
-    connect(m_timer, &QTimer::timeout, this, &TabSwitcher::timer);
+    m_patternLabel->setIndent(4);
+    m_patternLabel->setEnabled(false);
 }
 
 TabSwitcher::~TabSwitcher() = default;
 
 void TabSwitcher::showSwitcher()
 {
-    setModel(new AppModel(this, m_tabs));
+    m_accepted = true;
+    setPattern(QString());
 
     if (!model()->rowCount())
         return;
 
-    QStyleOptionViewItem option;
-
-    int w = 0;
-    int h = 0;
-    int maxApp = 15;
-
-    for(int i = 0; i < model()->rowCount(); ++i){
-        QSize siz = itemDelegate()->sizeHint(option, model()->index(i, 0));
-        w = qMax(w, siz.width());
-        h += siz.height();
-        if (i > maxApp)
-            break;
-    }
-
-
-    w += 2 * frameWidth();
-    h += 2 * frameWidth();
+    const int maxApp = 16;
+    const int labelHeight = m_patternLabel->sizeHint().height();
+    const int w = m_tabs->width() * 2 / 3;
+    const int h = sizeHintForRow(0) * qMin(model()->rowCount(), maxApp) + labelHeight + 2 * frameWidth();
     resize(w, h);
 
+    setViewportMargins(0, labelHeight, 0, 0);
+    m_patternLabel->setGeometry(frameWidth(), frameWidth(), w - 2 * frameWidth(), labelHeight);
+
     QPoint pos = m_tabs->mapToGlobal(m_tabs->geometry().topLeft());
     move(pos.x()+m_tabs->geometry().width()/2 - w / 2, pos.y()+m_tabs->geometry().height()/2 - h / 2);
 
@@ -141,12 +294,19 @@ void TabSwitcher::showSwitcher()
 void TabSwitcher::selectItem(bool forward)
 {
     if (!isVisible())
+    {
+        m_filtering = false;
         showSwitcher();
+        if (!isVisible())
+            return;
+        // the modifier may have been released before the popup appeared
+        if (QApplication::queryKeyboardModifiers() == Qt::NoModifier)
+            m_filtering = true;
+    }
 
     int current = currentIndex().row();
     current = (current < 0) ? 0 : current;
 
-    m_timer->start();
     current += forward ? 1 : -1;
 
     if(current >= model()->rowCount())
@@ -158,27 +318,75 @@ void TabSwitcher::selectItem(bool forward)
     setCurrentIndex(model()->index(current, 0));
 }
 
+void TabSwitcher::showFilter()
+{
+    if (!isVisible())
+    {
+        showSwitcher();
+        setCurrentIndex(model()->index(0, 0));
+    }
+    m_filtering = true;
+}
+
+void TabSwitcher::setPattern(const QString& pattern)
+{
+    m_filter->setPattern(pattern);
+    m_patternLabel->setText(pattern.isEmpty() ? tr("Type to filter") : pattern);
+    m_patternLabel->setEnabled(!pattern.isEmpty());
+    if (!pattern.isEmpty())
+        setCurrentIndex(model()->index(0, 0));
+}
+
+void TabSwitcher::keyPressEvent(QKeyEvent *event)
+{
+    switch (event->key()) {
+    case Qt::Key_Escape:
+        m_accepted = false;
+        close();
+        return;
+    case Qt::Key_Return:
+    case Qt::Key_Enter:
+        close();
+        return;
+    case Qt::Key_Backspace:
+        m_filtering = true;
+        setPattern(m_filter->pattern().chopped(qMin<qsizetype>(1, m_filter->pattern().size())));
+        return;
+    default:
+        break;
+    }
+
+    const QString text = typedText(event);
+    if (!text.isEmpty())
+    {
+        m_filtering = true;
+        setPattern(m_filter->pattern() + text);
+        return;
+    }
+
+    QListView::keyPressEvent(event);
+}
+
 void TabSwitcher::keyReleaseEvent(QKeyEvent *event)
 {
-    if (event->modifiers() == 0)
+    if (!m_filtering && event->modifiers() == 0)
         close();
 
     QWidget::keyReleaseEvent(event);
 }
 
-void TabSwitcher::timer()
+void TabSwitcher::mouseReleaseEvent(QMouseEvent *event)
 {
-    if (QApplication::queryKeyboardModifiers() == Qt::NoModifier)
+    QListView::mouseReleaseEvent(event);
+    if (indexAt(event->position().toPoint()).isValid())
         close();
-    else
-        m_timer->start();
 }
 
 void TabSwitcher::closeEvent(QCloseEvent *)
 {
-    m_timer->stop();
-    Q_EMIT activateTab(model()->data(model()->index(currentIndex().row(), 0), static_cast<int>(AppRole::Index)).value<int>());
+    const QModelIndex current = currentIndex();
+    if (m_accepted && current.isValid())
+        Q_EMIT activateTab(current.data(static_cast<int>(AppRole::Index)).value<int>());
 }
 
 // -----------------------------------------------------------------------------------------------------------
-
@@ -2,11 +2,18 @@
 
 #include <QListWidget>
 #include <QAbstractListModel>
+#include <QSortFilterProxyModel>
 
+class QLabel;
 class TabWidget;
 
 // -----------------------------------------------------------------------------------------------------------
 
+/*! Persistent index of the tabs of a TabWidget in most recently used order.
+
+Kept up to date from TabWidget signals, so showing the switcher does not
+rebuild anything.
+*/
 class AppModel : public QAbstractListModel
 {
     Q_OBJECT
@@ -18,12 +25,44 @@ protected:
     QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
 
 private:
+    void updateTab(QWidget* holder);
+    void removeTab(QWidget* holder);
+    void raiseTab(int tabIndex);
+    int rowOf(const QWidget* holder) const;
+
     struct AppInfo {
+        QWidget* holder;
         QString name;
-        int index;
+        QString cwd;
+        QString process;
     };
 
     QList<AppInfo> m_list;
+    TabWidget* m_tabs;
+};
+
+// -----------------------------------------------------------------------------------------------------------
+
+/*! Filters the tabs by a fuzzy match of the typed text against title,
+    working directory and foreground process, best matches first.
+ */
+class AppFilterModel : public QSortFilterProxyModel
+{
+    Q_OBJECT
+public:
+    AppFilterModel(QObject* parent);
+
+    void setPattern(const QString& pattern);
+    const QString& pattern() const { return m_pattern; }
+
+protected:
+    bool filterAcceptsRow(int sourceRow, const QModelIndex& sourceParent) const override;
+    bool lessThan(const QModelIndex& left, const QModelIndex& right) const override;
+
+private:
+    int score(const QModelIndex& sourceIndex) const;
+
+    QString m_pattern;
 };
 
 // -----------------------------------------------------------------------------------------------------------
@@ -36,22 +75,28 @@ public:
     TabSwitcher(TabWidget* tabs);
     ~TabSwitcher() override;
     void selectItem(bool forward = true);
+    void showFilter();
 
 signals:
     void activateTab(int index) const;
 
 protected:
+    void keyPressEvent(QKeyEvent *event) override;
     void keyReleaseEvent(QKeyEvent *event) override;
+    void mouseReleaseEvent(QMouseEvent *event) override;
     void closeEvent(QCloseEvent *) override;
 
 private:
     void showSwitcher();
-    void timer();
+    void setPattern(const QString& pattern);
 
 private:
-    QTimer *m_timer;
     TabWidget* m_tabs;
+    AppFilterModel* m_filter;
+    QLabel* m_patternLabel;
+    // Once the user types, the switcher no longer closes on modifier release
+    bool m_filtering;
+    bool m_accepted;
 };
 
 // -----------------------------------------------------------------------------------------------------------
-
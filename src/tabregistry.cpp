@@ -0,0 +1,86 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by LXQt team                                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include <QDateTime>
+
+#include "tabregistry.h"
+
+void TabRegistry::insert(int index, QObject *holder)
+{
+    index = qBound(0, index, count());
+    Entry e;
+    e.holder = holder;
+    e.lastActivity = QDateTime::currentMSecsSinceEpoch();
+    m_entries.insert(index, e);
+    reindex(index, count() - 1);
+}
+
+void TabRegistry::remove(int index)
+{
+    if (index < 0 || index >= m_entries.size())
+        return;
+    m_indices.remove(m_entries.at(index).holder);
+    m_entries.removeAt(index);
+    reindex(index, count() - 1);
+}
+
+void TabRegistry::remove(const QList<int> &indices)
+{
+    if (indices.isEmpty())
+        return;
+    for (int k = static_cast<int>(indices.size()) - 1; k >= 0; --k)
+    {
+        const int index = indices.at(k);
+        if (index < 0 || index >= m_entries.size())
+            continue;
+        m_indices.remove(m_entries.at(index).holder);
+        m_entries.removeAt(index);
+    }
+    reindex(qMax(0, indices.constFirst()), count() - 1);
+}
+
+void TabRegistry::move(int from, int to)
+{
+    if (from == to || from < 0 || to < 0 || from >= m_entries.size() || to >= m_entries.size())
+        return;
+    m_entries.move(from, to);
+    reindex(qMin(from, to), qMax(from, to));
+}
+
+void TabRegistry::clear()
+{
+    m_entries.clear();
+    m_indices.clear();
+}
+
+int TabRegistry::indexOf(const QObject *holder) const
+{
+    return m_indices.value(holder, -1);
+}
+
+QObject *TabRegistry::holder(int index) const
+{
+    if (index < 0 || index >= m_entries.size())
+        return nullptr;
+    return m_entries.at(index).holder;
+}
+
+void TabRegistry::reindex(int first, int last)
+{
+    for (int i = first; i <= last; ++i)
+        m_indices[m_entries.at(i).holder] = i;
+}
@@ -0,0 +1,72 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by LXQt team                                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#ifndef TABREGISTRY_H
+#define TABREGISTRY_H
+
+#include <QHash>
+#include <QList>
+#include <QString>
+
+class QObject;
+
+/*! \brief Bookkeeping of the tabs of a TabWidget.
+
+Maps every tab page (a TermWidgetHolder) to its index and to the per-tab
+metadata, and back. TabWidget keeps it in sync from tabInserted(),
+tabRemoved() and QTabBar::tabMoved(), so that looking up a tab is O(1) and
+only the entries whose index really changed are touched.
+*/
+class TabRegistry
+{
+public:
+    enum Indicator { NoIndicator, ActivityIndicator, SilenceIndicator };
+
+    struct Entry {
+        QObject *holder = nullptr;
+        QString title;
+        bool customName = false;
+        qint64 lastActivity = 0; // msecs since epoch
+        bool hibernated = false;
+        qint64 releasedBytes = 0;
+        // output arrived since the tab was current
+        bool unseenOutput = false;
+        Indicator indicator = NoIndicator;
+    };
+
+    void insert(int index, QObject *holder);
+    void remove(int index);
+    // several at once, \a indices in ascending order, reindexed once
+    void remove(const QList<int> &indices);
+    void move(int from, int to);
+    void clear();
+
+    int count() const { return static_cast<int>(m_entries.size()); }
+    int indexOf(const QObject *holder) const;
+    QObject *holder(int index) const;
+
+    Entry &entry(int index) { return m_entries[index]; }
+    const Entry &entry(int index) const { return m_entries.at(index); }
+
+private:
+    void reindex(int first, int last);
+
+    QList<Entry> m_entries;
+    QHash<const QObject*, int> m_indices;
+};
+
+#endif
@@ -16,6 +16,7 @@
  *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
  ***************************************************************************/
 
+#include <QApplication>
 #include <QTabBar>
 #include <QInputDialog>
 #include <QColorDialog>
@@ -24,6 +25,16 @@
 #include <QActionGroup>
 #include <QMessageBox>
 #include <QTimer>
+#include <QDateTime>
+#include <QLocale>
+#include <QDebug>
+#include <QCollator>
+#include <QToolTip>
+#include <QDrag>
+#include <QMimeData>
+#include <QPointer>
+
+#include <algorithm>
 
 #include "mainwindow.h"
 #include "termwidgetholder.h"
@@ -34,11 +45,16 @@
 #include "qterminalapp.h"
 #include "tab-switcher.h"
 
+// in-process only, the data is the index of the tab in the source bar
+static const char TAB_MIME_TYPE[] = "application/x-qterminal-tab";
 
-#define TAB_INDEX_PROPERTY "tab_index"
-#define TAB_CUSTOM_NAME_PROPERTY "custom_name"
-
-TabWidget::TabWidget(QWidget* parent) : QTabWidget(parent), tabNumerator(0), mTabBar(new TabBar(this)), mSwitcher(new TabSwitcher(this))
+TabWidget::TabWidget(QWidget* parent) : QTabWidget(parent), tabNumerator(0), mTabBar(new TabBar(this)), mSwitcher(new TabSwitcher(this)),
+    mHibernateTimer(new QTimer(this)),
+    mMeterTimer(new QTimer(this)),
+    mBroadcastMode(BroadcastOff),
+    mBroadcasting(false),
+    mClosingTabs(false),
+    mTabPressed(false)
 {
     // Insert our own tab bar which overrides tab width and eliding
     setTabBar(mTabBar);
@@ -57,15 +73,24 @@ TabWidget::TabWidget(QWidget* parent) : QTabWidget(parent), tabNumerator(0), mTa
     setUsesScrollButtons(true);
 
     tabBar()->installEventFilter(this);
+    tabBar()->setAcceptDrops(true);
 
     connect(this, &TabWidget::tabCloseRequested, this, [this](int indx) {
         removeTab(indx, true);
     });
-    connect(tabBar(), &QTabBar::tabMoved, this, &TabWidget::updateTabIndices);
+    connect(tabBar(), &QTabBar::tabMoved, this, &TabWidget::onTabMoved);
     connect(this, &TabWidget::tabRenameRequested, this, &TabWidget::renameSession);
     connect(this, &TabWidget::tabTitleColorChangeRequested, this, &TabWidget::setTitleColor);
     connect(mSwitcher.data(), &TabSwitcher::activateTab, this, &TabWidget::switchTab);
     connect(this, &TabWidget::currentChanged, this, &TabWidget::onCurrentChanged);
+    connect(this, &QTabWidget::currentChanged, this, &TabWidget::currentTitleChanged);
+
+    mHibernateTimer->setInterval(60 * 1000);
+    connect(mHibernateTimer, &QTimer::timeout, this, &TabWidget::hibernateIdleTabs);
+
+    mMeterTimer->setInterval(1000);
+    connect(mMeterTimer, &QTimer::timeout, this, &TabWidget::sampleOutput);
+    mMeterTimer->start();
 }
 
 TabWidget::~TabWidget()
@@ -86,28 +111,165 @@ int TabWidget::addNewTab(TerminalConfig config)
 
     TermWidgetHolder *ch = terminalHolder();
     if (ch)
-        config.provideCurrentDirectory(ch->currentTerminal()->impl()->workingDirectory());
+        config.provideCurrentDirectory(ch->currentTerminal()->workingDirectory());
 
     TermWidgetHolder *console = new TermWidgetHolder(config, this);
     console->setWindowTitle(label);
-    connect(console, &TermWidgetHolder::finished, this, &TabWidget::removeFinished);
-    connect(console, &TermWidgetHolder::lastTerminalClosed, this, &TabWidget::removeFinished);
-    connect(console, &TermWidgetHolder::termTitleChanged, this, &TabWidget::onTermTitleChanged);
-    connect(this, &QTabWidget::currentChanged, this, &TabWidget::currentTitleChanged);
 
     const int newIndex = (Properties::Instance()->m_openNewTabRightToActiveTab ? currentIndex() + 1 : count());
-    const int index = insertTab(newIndex, console, label);
+    const int index = insertHolder(console, newIndex, label);
 
-    console->setProperty(TAB_CUSTOM_NAME_PROPERTY, false);
-    updateTabIndices();
-    switchTab(index);
-    console->setInitialFocus();
+    // a lazy tab stays in the background until it is activated
+    if (!config.isLazy() || count() == 1)
+    {
+        switchTab(index);
+        console->setInitialFocus();
+    }
 
     showHideTabBar();
 
     return index;
 }
 
+int TabWidget::insertHolder(TermWidgetHolder *holder, int index, const QString &label)
+{
+    connect(holder, &TermWidgetHolder::finished, this, &TabWidget::removeFinished);
+    connect(holder, &TermWidgetHolder::lastTerminalClosed, this, &TabWidget::removeFinished);
+    connect(holder, &TermWidgetHolder::termTitleChanged, this, &TabWidget::onTermTitleChanged);
+    connect(holder, &TermWidgetHolder::terminalCountChanged, this, &TabWidget::onTerminalCountChanged);
+    connect(holder, &TermWidgetHolder::userInput, this, &TabWidget::broadcastInput);
+
+    const int inserted = insertTab(index, holder, label);
+    mTabs.entry(inserted).title = label;
+    return inserted;
+}
+
+int TabWidget::moveTabTo(int index, TabWidget *target, int targetIndex)
+{
+    if (index < 0 || index >= count() || target == nullptr)
+        return -1;
+    if (target == this)
+    {
+        const int to = (targetIndex < 0 || targetIndex >= count()) ? count() - 1 : targetIndex;
+        tabBar()->moveTab(index, to);
+        return to;
+    }
+
+    TermWidgetHolder *holder = static_cast<TermWidgetHolder*>(widget(index));
+    TabRegistry::Entry entry = mTabs.entry(index);
+    const QString text = tabText(index);
+    const QColor color = tabBar()->tabTextColor(index);
+
+    // only the layout of the new window decides the size of the ptys
+    const auto terminals = holder->findChildren<TermWidget*>();
+    for (TermWidget *term : terminals)
+        term->setGeometryHeld(true);
+
+    disconnect(holder, nullptr, this, nullptr);
+    mHistory.removeAll(holder);
+    QTabWidget::removeTab(index);
+
+    const int inserted = target->insertHolder(holder, targetIndex, text);
+    entry.indicator = TabRegistry::NoIndicator;
+    target->mTabs.entry(inserted) = entry;
+    if (color.isValid())
+        target->tabBar()->setTabTextColor(inserted, color);
+    target->updateBroadcastMembers();
+    target->switchTab(inserted);
+    target->showHideTabBar();
+    for (TermWidget *term : terminals)
+        term->setGeometryHeld(false);
+    holder->currentTerminal()->setFocus(Qt::OtherFocusReason);
+
+    if (count() == 0)
+    {
+        emit closeLastTabNotification();
+    }
+    else
+    {
+        qobject_cast<TermWidgetHolder*>(currentWidget())->setInitialFocus();
+        showHideTabBar();
+    }
+    return inserted;
+}
+
+int TabWidget::moveTerminalToNewTab(TermWidget *term, TabWidget *target)
+{
+    TermWidgetHolder *holder = findParent<TermWidgetHolder>(term);
+    const int index = mTabs.indexOf(holder);
+    if (index < 0 || target == nullptr)
+        return -1;
+
+    // a terminal alone in its tab takes the tab along
+    if (holder->terminalCount() < 2)
+        return target == this ? index : moveTabTo(index, target);
+
+    holder->takeTerminal(term);
+    TermWidgetHolder *console = new TermWidgetHolder(term, target);
+    target->tabNumerator++;
+    QString label = QString(tr("Shell No. %1")).arg(target->tabNumerator);
+    console->setWindowTitle(label);
+    if (!term->isPending() && term->impl()->isTitleChanged())
+        label = term->impl()->title();
+
+    const int inserted = target->insertHolder(console, target->count(), label);
+    target->updateBroadcastMembers();
+    target->switchTab(inserted);
+    target->showHideTabBar();
+    term->setFocus(Qt::OtherFocusReason);
+    return inserted;
+}
+
+MainWindow *TabWidget::moveTabToNewWindow(int index, const QPoint &pos)
+{
+    if (count() < 2 || index < 0 || index >= count())
+        return nullptr;
+
+    // the first tab of the new window is replaced before its shell starts
+    TerminalConfig cfg;
+    cfg.setLazy(true);
+    MainWindow *window = new MainWindow(cfg, false);
+    TabWidget *tabs = window->tabWidget();
+    moveTabTo(index, tabs, 0);
+    tabs->removeTab(1);
+    if (!pos.isNull())
+        window->move(pos);
+    window->show();
+    return window;
+}
+
+void TabWidget::moveSubterminalToNewTab()
+{
+    moveTerminalToNewTab(terminalHolder()->currentTerminal(), this);
+}
+
+void TabWidget::moveCurrentTabToNewWindow()
+{
+    moveTabToNewWindow(currentIndex());
+}
+
+void TabWidget::startTabDrag()
+{
+    // ends the move of the tab within the bar, which may change its index
+    QMouseEvent release(QEvent::MouseButtonRelease, mDragStart, tabBar()->mapToGlobal(mDragStart),
+                        Qt::LeftButton, Qt::NoButton, Qt::NoModifier);
+    QCoreApplication::sendEvent(tabBar(), &release);
+    const int index = currentIndex();
+
+    QMimeData *mime = new QMimeData;
+    mime->setData(QLatin1String(TAB_MIME_TYPE), QByteArray::number(index));
+    QDrag *drag = new QDrag(tabBar());
+    drag->setMimeData(mime);
+    drag->setPixmap(tabBar()->grab(tabBar()->tabRect(index)));
+    if (drag->exec(Qt::MoveAction) != Qt::IgnoreAction)
+        return;
+
+    // dropped outside of any tab bar, the tab becomes a window; a drag
+    // given up over its own window is a change of mind
+    if (!window()->frameGeometry().contains(QCursor::pos()))
+        moveTabToNewWindow(index, QCursor::pos());
+}
+
 void TabWidget::switchLeftSubterminal()
 {
     terminalHolder()->directionalNavigation(NavigationDirection::Left);
@@ -129,13 +291,16 @@ void TabWidget::switchBottomSubterminal() {
 void TabWidget::splitHorizontally()
 {
     terminalHolder()->splitHorizontal(terminalHolder()->currentTerminal());
-    findParent<MainWindow>(this)->updateDisabledActions();
 }
 
 void TabWidget::splitVertically()
 {
     terminalHolder()->splitVertical(terminalHolder()->currentTerminal());
-    findParent<MainWindow>(this)->updateDisabledActions();
+}
+
+void TabWidget::toggleMaximizedSubterminal()
+{
+    terminalHolder()->toggleMaximized();
 }
 
 void TabWidget::splitCollapse()
@@ -156,7 +321,6 @@ void TabWidget::splitCollapse()
     }
 
     terminalHolder()->splitCollapse(terminalHolder()->currentTerminal());
-    win->updateDisabledActions();
 }
 
 void TabWidget::copySelection()
@@ -166,12 +330,12 @@ void TabWidget::copySelection()
 
 void TabWidget::pasteClipboard()
 {
-    terminalHolder()->currentTerminal()->impl()->pasteClipboard();
+    terminalHolder()->currentTerminal()->pasteClipboard();
 }
 
 void TabWidget::pasteSelection()
 {
-    terminalHolder()->currentTerminal()->impl()->pasteSelection();
+    terminalHolder()->currentTerminal()->pasteSelection();
 }
 
 void TabWidget::zoomIn()
@@ -189,20 +353,139 @@ void TabWidget::zoomReset()
     terminalHolder()->currentTerminal()->impl()->zoomReset();
 }
 
-void TabWidget::updateTabIndices()
+void TabWidget::tabInserted(int index)
 {
-    for(int i = 0; i < count(); i++)
-        widget(i)->setProperty(TAB_INDEX_PROPERTY, i);
+    mTabs.insert(index, widget(index));
+    QTabWidget::tabInserted(index);
+    if (mBroadcastMode != BroadcastOff)
+        updateBroadcastMembers();
+    emit tabOpened(widget(index));
+    emit tabInfoChanged(widget(index));
+    emit tabCountChanged(count());
 }
 
-void TabWidget::onTermTitleChanged(const QString& title, const QString& icon)
+void TabWidget::tabRemoved(int index)
+{
+    emit tabClosed(static_cast<QWidget*>(mTabs.holder(index)));
+    QTabWidget::tabRemoved(index);
+    // the tabs go from the last one, so those before the index still match
+    if (mClosingTabs)
+        return;
+    mTabs.remove(index);
+    if (mBroadcastMode == BroadcastAllTabs)
+        updateBroadcastMembers();
+    emit tabCountChanged(count());
+}
+
+void TabWidget::onTerminalCountChanged(int count)
+{
+    if (sender() == currentWidget())
+        emit currentTerminalCountChanged(count);
+    if (mBroadcastMode != BroadcastOff)
+        updateBroadcastMembers();
+}
+
+void TabWidget::setBroadcastMode(BroadcastMode mode)
+{
+    if (mBroadcastMode == mode)
+        return;
+    mBroadcastMode = mode;
+    // the selection starts with the current terminal
+    if (mode == BroadcastSelection)
+    {
+        if (TermWidgetHolder *holder = terminalHolder())
+            holder->currentTerminal()->setBroadcastSelected(true);
+    }
+    updateBroadcastMembers();
+    emit broadcastModeChanged(mode);
+}
+
+void TabWidget::toggleBroadcastSelection()
+{
+    TermWidgetHolder *holder = terminalHolder();
+    if (holder == nullptr)
+        return;
+    TermWidget *term = holder->currentTerminal();
+    term->setBroadcastSelected(!term->isBroadcastSelected());
+    if (mBroadcastMode != BroadcastSelection)
+        setBroadcastMode(BroadcastSelection);
+    else
+        updateBroadcastMembers();
+}
+
+void TabWidget::updateBroadcastMembers()
 {
-    TermWidgetHolder * console = qobject_cast<TermWidgetHolder*>(sender());
-    const bool custom_name = console->property(TAB_CUSTOM_NAME_PROPERTY).toBool();
-    if (!custom_name)
+    for (int i = 0; i < count(); ++i)
     {
-        const int index = console->property(TAB_INDEX_PROPERTY).toInt();
+        // not terminals(), a new terminal is a child before it is laid out
+        const auto terminals = widget(i)->findChildren<TermWidget*>();
+        for (TermWidget *term : terminals)
+        {
+            bool member = false;
+            switch (mBroadcastMode) {
+            case BroadcastOff:
+                break;
+            case BroadcastTab:
+                member = terminals.size() > 1;
+                break;
+            case BroadcastAllTabs:
+                member = count() > 1 || terminals.size() > 1;
+                break;
+            case BroadcastSelection:
+                member = term->isBroadcastSelected();
+                break;
+            }
+            term->setBroadcastMember(member);
+        }
+    }
+}
+
+void TabWidget::broadcastInput(TermWidget *source, const QString &text)
+{
+    if (mBroadcastMode == BroadcastOff || mBroadcasting || text.isEmpty()
+        || !source->isBroadcastMember())
+        return;
+
+    // sendText() only feeds the pty, but never trust it not to come back
+    mBroadcasting = true;
+    auto send = [source, &text](const QList<TermWidget*> &terminals) {
+        for (TermWidget *term : terminals)
+        {
+            // a lazy terminal has no program to type into yet
+            if (term != source && term->isBroadcastMember() && !term->isPending())
+                term->impl()->sendText(text);
+        }
+    };
+    if (mBroadcastMode == BroadcastTab)
+    {
+        send(static_cast<TermWidgetHolder*>(sender())->terminals());
+    }
+    else
+    {
+        for (int i = 0; i < count(); ++i)
+            send(static_cast<TermWidgetHolder*>(widget(i))->terminals());
+    }
+    mBroadcasting = false;
+}
 
+void TabWidget::onTabMoved(int from, int to)
+{
+    mTabs.move(from, to);
+}
+
+int TabWidget::tabIndex(const QWidget *holder) const
+{
+    return mTabs.indexOf(holder);
+}
+
+void TabWidget::onTermTitleChanged(const QString& title, const QString& icon)
+{
+    const int index = mTabs.indexOf(sender());
+    if (index < 0)
+        return;
+    TabRegistry::Entry &entry = mTabs.entry(index);
+    if (!entry.customName)
+    {
         /* In xterm, the icon string maps to the X11 WM_ICON_NAME property.
          * Doing nothing here for several reasons:
          * 1. Few X11 window managers use that
@@ -210,10 +493,15 @@ void TabWidget::onTermTitleChanged(const QString& title, const QString& icon)
          */
         Q_UNUSED(icon);
 
+        // setTabText() relayouts the whole tab bar
+        if (entry.title == title)
+            return;
+        entry.title = title;
         setTabText(index, title);
         if (currentIndex() == index)
             emit currentTitleChanged(index);
     }
+    emit tabInfoChanged(widget(index));
 }
 
 void TabWidget::renameSession(int index)
@@ -223,13 +511,101 @@ void TabWidget::renameSession(int index)
                                         tr("New tab name:"), QLineEdit::Normal,
                                         QString(), &ok);
     if(ok && !text.isEmpty())
+        setCustomTabTitle(index, text);
+}
+
+void TabWidget::setCustomTabTitle(int index, const QString &text)
+{
+    setTabIcon(index, QIcon{});
+    setTabText(index, text);
+    mTabs.entry(index).title = text;
+    mTabs.entry(index).customName = true;
+    if (currentIndex() == index)
+        emit currentTitleChanged(index);
+    emit tabInfoChanged(widget(index));
+}
+
+QVariantList TabWidget::session() const
+{
+    QVariantList tabs;
+    for (int i = 0; i < count(); ++i)
     {
-        setTabIcon(index, QIcon{});
-        setTabText(index, text);
-        widget(index)->setProperty(TAB_CUSTOM_NAME_PROPERTY, true);
-        if (currentIndex() == index)
-            emit currentTitleChanged(index);
+        const TabRegistry::Entry &entry = mTabs.entry(i);
+        QVariantMap tab;
+        tab[QStringLiteral("title")] = entry.title;
+        tab[QStringLiteral("customName")] = entry.customName;
+        tab[QStringLiteral("layout")] = static_cast<TermWidgetHolder*>(widget(i))->layout();
+        tabs.append(tab);
     }
+    return tabs;
+}
+
+void TabWidget::restoreSession(const QVariantList &tabs, int current)
+{
+    // the first tab of a new window is reused, the others start lazily
+    setUpdatesEnabled(false);
+    for (int i = 0; i < tabs.size(); ++i)
+    {
+        const QVariantMap tab = tabs.at(i).toMap();
+        int index = i;
+        if (index >= count())
+        {
+            TerminalConfig cfg;
+            cfg.setLazy(true);
+            index = addNewTab(cfg);
+        }
+
+        TermWidgetHolder *holder = static_cast<TermWidgetHolder*>(widget(index));
+        if (!holder->restoreLayout(tab.value(QStringLiteral("layout"))))
+            qWarning() << "Tab" << i << "of the session has no valid layout";
+        if (tab.value(QStringLiteral("customName")).toBool())
+            setCustomTabTitle(index, tab.value(QStringLiteral("title")).toString());
+    }
+    if (current >= 0 && current < count())
+        setCurrentIndex(current);
+    setUpdatesEnabled(true);
+}
+
+QList<TermWidgetHolder*> TabWidget::addTabs(const QVariantList &tabs, bool replaceFirst)
+{
+    QList<TermWidgetHolder*> holders;
+    for (const QVariant &tab : tabs)
+    {
+        if (!SplitTree::isValid(tab.toMap().value(QStringLiteral("layout"))))
+            return holders;
+    }
+
+    // in the given order, whichever side new tabs open on
+    int position = Properties::Instance()->m_openNewTabRightToActiveTab ? currentIndex() + 1 : count();
+    setUpdatesEnabled(false);
+    for (int i = 0; i < tabs.size(); ++i)
+    {
+        const QVariantMap tab = tabs.at(i).toMap();
+        TermWidgetHolder *holder = nullptr;
+        if (replaceFirst && i == 0 && count() > 0)
+        {
+            holder = static_cast<TermWidgetHolder*>(widget(0));
+        }
+        else
+        {
+            TerminalConfig cfg;
+            cfg.setLazy(true);
+            holder = new TermWidgetHolder(cfg, this);
+            tabNumerator++;
+            const QString label = QString(tr("Shell No. %1")).arg(tabNumerator);
+            holder->setWindowTitle(label);
+            insertHolder(holder, position++, label);
+        }
+
+        holder->restoreLayout(tab.value(QStringLiteral("layout")));
+        const QString title = tab.value(QStringLiteral("title")).toString();
+        if (!title.isEmpty())
+            setCustomTabTitle(mTabs.indexOf(holder), title);
+        holders.append(holder);
+    }
+    setUpdatesEnabled(true);
+    showHideTabBar();
+    return holders;
 }
 
 void TabWidget::renameCurrentSession()
@@ -275,6 +651,34 @@ void TabWidget::contextMenuEvent(QContextMenuEvent *event)
     rename->setShortcut(actions[QLatin1String(RENAME_SESSION)]->shortcut());
     rename->blockSignals(true);
 
+    menu.addSeparator();
+    QAction *closeOthers = menu.addAction(tr("Close other tabs"));
+    QAction *closeRight = menu.addAction(tr("Close tabs to the right"));
+    QAction *closeIdle = menu.addAction(tr("Close idle tabs"));
+    closeOthers->setEnabled(count() > 1);
+    closeRight->setEnabled(tabIndex < count() - 1);
+    closeIdle->setEnabled(count() > 1);
+    QMenu *sortMenu = menu.addMenu(tr("Sort tabs"));
+    sortMenu->setEnabled(count() > 1);
+    QAction *sortTitle = sortMenu->addAction(tr("By title"));
+    QAction *sortDirectory = sortMenu->addAction(tr("By working directory"));
+    QAction *sortActivity = sortMenu->addAction(tr("By last use"));
+
+    menu.addSeparator();
+    QAction *toNewWindow = menu.addAction(QIcon::fromTheme(QStringLiteral("window-new")), tr("Move to new window"));
+    toNewWindow->setEnabled(count() > 1);
+    QMenu *toWindowMenu = menu.addMenu(tr("Move to window"));
+    QList<QPointer<MainWindow>> windows;
+    const auto allWindows = QTerminalApp::Instance()->getWindowList();
+    for (MainWindow *w : allWindows)
+    {
+        if (w->tabWidget() == this)
+            continue;
+        toWindowMenu->addAction(w->windowTitle())->setData(static_cast<int>(windows.size()));
+        windows.append(w);
+    }
+    toWindowMenu->setEnabled(!windows.isEmpty());
+
     QAction *action = menu.exec(event->globalPos());
     if (action == close) {
         emit tabCloseRequested(tabIndex);
@@ -282,12 +686,226 @@ void TabWidget::contextMenuEvent(QContextMenuEvent *event)
         emit tabRenameRequested(tabIndex);
     } else if (action == changeColor) {
         emit tabTitleColorChangeRequested(tabIndex);
+    } else if (action == closeOthers) {
+        closeOtherTabs(tabIndex);
+    } else if (action == closeRight) {
+        closeTabsToRight(tabIndex);
+    } else if (action == closeIdle) {
+        closeIdleTabs();
+    } else if (action == sortTitle) {
+        sortTabs(SortByTitle);
+    } else if (action == sortDirectory) {
+        sortTabs(SortByDirectory);
+    } else if (action == sortActivity) {
+        sortTabs(SortByActivity);
+    } else if (action == toNewWindow) {
+        moveTabToNewWindow(tabIndex);
+    } else if (action != nullptr && action->parent() == toWindowMenu) {
+        QPointer<MainWindow> w = windows.value(action->data().toInt());
+        if (!w.isNull())
+            moveTabTo(tabIndex, w->tabWidget());
+    }
+}
+
+int TabWidget::closeTabsIf(const std::function<bool(int)>& predicate, bool prompt)
+{
+    QList<int> doomed;
+    for (int i = 0; i < count(); ++i)
+    {
+        if (predicate(i))
+            doomed.append(i);
+    }
+    if (doomed.size() == count())
+        doomed.removeAll(currentIndex());
+    if (doomed.isEmpty())
+        return 0;
+
+    if (prompt && Properties::Instance()->askOnExit)
+    {
+        const bool running = std::any_of(doomed.cbegin(), doomed.cend(), [this](int i) {
+            return static_cast<TermWidgetHolder*>(widget(i))->hasRunningProcess();
+        });
+        if (running && !findParent<MainWindow>(this)->closePrompt(tr("Close tabs"),
+                tr("Are you sure you want to close %n tabs?", "", static_cast<int>(doomed.size()))))
+        {
+            return 0;
+        }
+    }
+
+    setUpdatesEnabled(false);
+
+    // leave a closing current tab first, so that the current tab changes once
+    if (doomed.contains(currentIndex()))
+    {
+        int survivor = -1;
+        for (QWidget *w : std::as_const(mHistory))
+        {
+            const int i = mTabs.indexOf(w);
+            if (i >= 0 && !doomed.contains(i))
+            {
+                survivor = i;
+                break;
+            }
+        }
+        for (int i = 0; survivor < 0 && i < count(); ++i)
+        {
+            if (!doomed.contains(i))
+                survivor = i;
+        }
+        setCurrentIndex(survivor);
     }
+
+    mClosingTabs = true;
+    for (int k = doomed.size() - 1; k >= 0; --k)
+    {
+        QWidget *w = widget(doomed.at(k));
+        mHistory.removeAll(w);
+        QTabWidget::removeTab(doomed.at(k));
+        w->deleteLater();
+    }
+    mClosingTabs = false;
+    mTabs.remove(doomed);
+    if (mBroadcastMode == BroadcastAllTabs)
+        updateBroadcastMembers();
+    emit tabCountChanged(count());
+
+    if (TermWidgetHolder *holder = qobject_cast<TermWidgetHolder*>(currentWidget()))
+        holder->setInitialFocus();
+    setUpdatesEnabled(true);
+
+    renameTabsAfterRemove();
+    showHideTabBar();
+    return static_cast<int>(doomed.size());
+}
+
+int TabWidget::closeOtherTabs(int index)
+{
+    return closeTabsIf([index](int i) { return i != index; }, true);
+}
+
+int TabWidget::closeTabsToRight(int index)
+{
+    return closeTabsIf([index](int i) { return i > index; }, true);
+}
+
+int TabWidget::closeIdleTabs()
+{
+    // nothing but the shell is running in them, so there is nothing to ask
+    return closeTabsIf([this](int i) {
+        return !static_cast<TermWidgetHolder*>(widget(i))->hasRunningProcess();
+    }, false);
+}
+
+void TabWidget::sortTabs(SortKey key)
+{
+    if (count() < 2)
+        return;
+
+    struct SortItem {
+        QWidget *holder;
+        QString text;
+        qint64 lastActivity;
+    };
+    QList<SortItem> items;
+    for (int i = 0; i < count(); ++i)
+    {
+        TermWidgetHolder *holder = static_cast<TermWidgetHolder*>(widget(i));
+        QString text;
+        if (key == SortByTitle)
+            text = tabText(i);
+        else if (key == SortByDirectory)
+            text = holder->currentTerminal()->workingDirectory();
+        // the current tab is in use right now
+        const qint64 lastActivity = i == currentIndex() ? QDateTime::currentMSecsSinceEpoch() : mTabs.entry(i).lastActivity;
+        items.append({holder, text, lastActivity});
+    }
+
+    if (key == SortByActivity)
+    {
+        std::stable_sort(items.begin(), items.end(), [](const SortItem &a, const SortItem &b) {
+            return a.lastActivity > b.lastActivity;
+        });
+    }
+    else
+    {
+        // "Shell No. 10" after "Shell No. 9"
+        QCollator collator;
+        collator.setNumericMode(true);
+        collator.setCaseSensitivity(Qt::CaseInsensitive);
+        std::stable_sort(items.begin(), items.end(), [&collator](const SortItem &a, const SortItem &b) {
+            return collator.compare(a.text, b.text) < 0;
+        });
+    }
+
+    // moving keeps the pages, their tab data and the current tab
+    setUpdatesEnabled(false);
+    for (int i = 0; i < items.size(); ++i)
+    {
+        const int from = mTabs.indexOf(items.at(i).holder);
+        if (from != i)
+            tabBar()->moveTab(from, i);
+    }
+    setUpdatesEnabled(true);
 }
 
 bool TabWidget::eventFilter(QObject *obj, QEvent *event)
 {
+    if (event->type() == QEvent::ToolTip)
+    {
+        // built on demand, so the meters never have to update tooltips
+        QHelpEvent *he = static_cast<QHelpEvent*>(event);
+        const int index = tabBar()->tabAt(he->pos());
+        if (index >= 0)
+            QToolTip::showText(he->globalPos(), tabToolTipText(index), tabBar());
+        else
+            QToolTip::hideText();
+        return true;
+    }
+    if (event->type() == QEvent::DragEnter || event->type() == QEvent::DragMove)
+    {
+        QDragMoveEvent *de = static_cast<QDragMoveEvent*>(event);
+        if (de->mimeData()->hasFormat(QLatin1String(TAB_MIME_TYPE)) && qobject_cast<TabBar*>(de->source()))
+        {
+            de->acceptProposedAction();
+            return true;
+        }
+        return QTabWidget::eventFilter(obj, event);
+    }
+    if (event->type() == QEvent::Drop)
+    {
+        QDropEvent *de = static_cast<QDropEvent*>(event);
+        TabBar *bar = qobject_cast<TabBar*>(de->source());
+        TabWidget *source = bar != nullptr ? qobject_cast<TabWidget*>(bar->parentWidget()) : nullptr;
+        if (source != nullptr && de->mimeData()->hasFormat(QLatin1String(TAB_MIME_TYPE)))
+        {
+            const int index = de->mimeData()->data(QLatin1String(TAB_MIME_TYPE)).toInt();
+            de->acceptProposedAction();
+            source->moveTabTo(index, this, tabBar()->tabAt(de->position().toPoint()));
+            return true;
+        }
+        return QTabWidget::eventFilter(obj, event);
+    }
     QMouseEvent *e = reinterpret_cast<QMouseEvent*>(event);
+    if (event->type() == QEvent::MouseButtonPress)
+    {
+        mTabPressed = e->button() == Qt::LeftButton && tabBar()->tabAt(e->pos()) >= 0;
+        mDragStart = e->pos();
+    }
+    else if (event->type() == QEvent::MouseButtonRelease)
+    {
+        mTabPressed = false;
+    }
+    else if (event->type() == QEvent::MouseMove && mTabPressed && (e->buttons() & Qt::LeftButton))
+    {
+        // well away from the bar, not just a sloppy move within it
+        const int margin = QApplication::startDragDistance() * 4;
+        if (!tabBar()->rect().adjusted(-margin, -margin, margin, margin).contains(e->pos()))
+        {
+            mTabPressed = false;
+            startTabDrag();
+            return true;
+        }
+    }
     if (e->button() == Qt::MiddleButton) {
         if (event->type() == QEvent::MouseButtonRelease && Properties::Instance()->closeTabOnMiddleClick)
         {
@@ -334,11 +952,9 @@ bool TabWidget::eventFilter(QObject *obj, QEvent *event)
 
 void TabWidget::removeFinished()
 {
-    QObject* term = sender();
-    QVariant prop = term->property(TAB_INDEX_PROPERTY);
-    if(prop.isValid() && prop.canConvert<int>())
+    const int index = mTabs.indexOf(sender());
+    if (index >= 0)
     {
-        int index = prop.toInt();
         removeTab(index);
     }
 }
@@ -368,7 +984,6 @@ void TabWidget::removeTab(int index, bool prompt)
         QTabWidget::removeTab(index);
         w->deleteLater();
 
-        updateTabIndices();
         int current = currentIndex();
         if (current >= 0 )
         {
@@ -399,14 +1014,147 @@ void TabWidget::onAction()
 
 void TabWidget::onCurrentChanged(int index)
 {
-    // update disabled actions, but only after probable subterminals are added
-    QTimer::singleShot(0, this, [this] {
-        findParent<MainWindow>(this)->updateDisabledActions();
-    });
+    // only the index of the current tab moves while others are closed
+    if (mClosingTabs)
+        return;
+    TermWidgetHolder *holder = qobject_cast<TermWidgetHolder*>(widget(index));
+    emit currentTerminalCountChanged(holder ? holder->terminalCount() : 0);
+
+    // the tab that is left has been in use until now
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    if (!mHistory.isEmpty())
+    {
+        const int previous = mTabs.indexOf(mHistory.constFirst());
+        if (previous >= 0)
+            mTabs.entry(previous).lastActivity = now;
+    }
     // also, update history
     auto* w = widget(index);
     mHistory.removeAll(w);
     mHistory.prepend(w);
+
+    // QTabWidget may report a new current tab before tabInserted()
+    const int registered = mTabs.indexOf(w);
+    if (registered >= 0)
+    {
+        mTabs.entry(registered).lastActivity = now;
+        mTabs.entry(registered).unseenOutput = false;
+        setIndicator(registered, TabRegistry::NoIndicator);
+        wakeTab(registered);
+    }
+}
+
+void TabWidget::hibernateIdleTabs()
+{
+    const int minutes = Properties::Instance()->hibernateIdleTabsAfter;
+    if (minutes <= 0)
+        return;
+
+    const qint64 deadline = QDateTime::currentMSecsSinceEpoch() - qint64(minutes) * 60 * 1000;
+    for (int i = 0; i < mTabs.count(); ++i)
+    {
+        TabRegistry::Entry &entry = mTabs.entry(i);
+        if (i == currentIndex() || entry.hibernated || entry.lastActivity > deadline)
+            continue;
+
+        qint64 released = 0;
+        const auto terminals = static_cast<TermWidgetHolder*>(widget(i))->terminals();
+        for (TermWidget *term : terminals)
+            released += term->hibernate();
+        entry.hibernated = true;
+        entry.releasedBytes = released;
+    }
+}
+
+void TabWidget::wakeTab(int index)
+{
+    TabRegistry::Entry &entry = mTabs.entry(index);
+    if (!entry.hibernated)
+        return;
+
+    entry.hibernated = false;
+    const auto terminals = static_cast<TermWidgetHolder*>(widget(index))->terminals();
+    for (TermWidget *term : terminals)
+        term->wake();
+    entry.releasedBytes = 0;
+}
+
+void TabWidget::sampleOutput()
+{
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    const qint64 silence = qint64(Properties::Instance()->silenceSeconds) * 1000;
+    for (int i = 0; i < mTabs.count(); ++i)
+    {
+        bool output = false;
+        qint64 lastOutput = 0;
+        const auto terminals = static_cast<TermWidgetHolder*>(widget(i))->terminals();
+        for (TermWidget *term : terminals)
+        {
+            OutputMeter &meter = term->outputMeter();
+            meter.sample(now);
+            output = output || meter.bytesPerSecond() > 0;
+            lastOutput = qMax(lastOutput, meter.lastOutput());
+        }
+
+        if (i == currentIndex())
+            continue;
+        TabRegistry::Entry &entry = mTabs.entry(i);
+        if (output)
+        {
+            entry.unseenOutput = true;
+            setIndicator(i, TabRegistry::ActivityIndicator);
+        }
+        else if (entry.unseenOutput && silence > 0 && now - lastOutput >= silence)
+        {
+            setIndicator(i, TabRegistry::SilenceIndicator);
+        }
+    }
+}
+
+void TabWidget::setIndicator(int index, TabRegistry::Indicator indicator)
+{
+    // setTabIcon() relayouts the tab bar, so only touch it on changes
+    TabRegistry::Entry &entry = mTabs.entry(index);
+    if (entry.indicator == indicator)
+        return;
+    entry.indicator = indicator;
+
+    switch (indicator) {
+    case TabRegistry::ActivityIndicator:
+        setTabIcon(index, QIcon::fromTheme(QStringLiteral("dialog-information")));
+        break;
+    case TabRegistry::SilenceIndicator:
+        setTabIcon(index, QIcon::fromTheme(QStringLiteral("media-playback-pause")));
+        break;
+    case TabRegistry::NoIndicator:
+        setTabIcon(index, QIcon{});
+        break;
+    }
+}
+
+QString TabWidget::tabToolTipText(int index) const
+{
+    const TabRegistry::Entry &entry = mTabs.entry(index);
+    QStringList lines{tabText(index)};
+
+    TermWidgetHolder *holder = static_cast<TermWidgetHolder*>(widget(index));
+    if (TermWidget *term = holder->currentTerminal())
+    {
+        const OutputMeter &meter = term->outputMeter();
+        const qint64 since = meter.msecsSinceOutput(QDateTime::currentMSecsSinceEpoch());
+        if (since >= 0)
+        {
+            lines << tr("Output: %1/s, %2 lines/s")
+                         .arg(QLocale().formattedDataSize(qint64(meter.bytesPerSecond())))
+                         .arg(meter.linesPerSecond(), 0, 'f', 1);
+            lines << tr("Last output %n second(s) ago", "", int(since / 1000));
+            lines << meter.sparkline();
+        }
+    }
+
+    if (entry.hibernated)
+        lines << tr("Hibernated, about %1 released").arg(QLocale().formattedDataSize(entry.releasedBytes));
+    return lines.join(QLatin1Char('\n'));
 }
 
 const QList<QWidget*>& TabWidget::history() const
@@ -445,6 +1193,11 @@ void TabWidget::switchToPrev()
     mSwitcher->selectItem(true);
 }
 
+void TabWidget::findTab()
+{
+    mSwitcher->showFilter();
+}
+
 
 void TabWidget::move(Direction dir)
 {
@@ -452,9 +1205,6 @@ void TabWidget::move(Direction dir)
     {
         int index = currentIndex();
         QWidget* child  = widget(index);
-        QString label   = tabText(index);
-        QString toolTip = tabToolTip(index);
-        QIcon   icon    = tabIcon(index);
 
         int newIndex = 0;
         if(dir == Left)
@@ -468,15 +1218,10 @@ void TabWidget::move(Direction dir)
             else
                 newIndex = index + 1;
 
-        setUpdatesEnabled(false);
-        QTabWidget::removeTab(index);
-        newIndex = insertTab(newIndex, child, label);
-        setTabToolTip(newIndex, toolTip);
-        setTabIcon(newIndex, icon);
-        setUpdatesEnabled(true);
+        // a single move keeps the page, its tab data and the registry entry
+        tabBar()->moveTab(index, newIndex);
         switchTab(newIndex);
         child->setFocus();
-        updateTabIndices();
     }
 }
 
@@ -540,6 +1285,11 @@ void TabWidget::propertiesChanged()
     }
     showHideTabBar();
 
+    if (Properties::Instance()->hibernateIdleTabsAfter > 0)
+        mHibernateTimer->start();
+    else
+        mHibernateTimer->stop();
+
     setTabsClosable(Properties::Instance()->showCloseTabButton);
 
     // Update the tab widths
@@ -553,17 +1303,6 @@ void TabWidget::clearActiveTerminal()
     reinterpret_cast<TermWidgetHolder*>(widget(currentIndex()))->clearActiveTerminal();
 }
 
-void TabWidget::saveSession()
-{
-    int ix = currentIndex();
-    reinterpret_cast<TermWidgetHolder*>(widget(ix))->saveSession(tabText(ix));
-}
-
-void TabWidget::loadSession()
-{
-    reinterpret_cast<TermWidgetHolder*>(widget(currentIndex()))->loadSession();
-}
-
 void TabWidget::preset2Horizontal()
 {
     TerminalConfig defaultConfig;
@@ -23,6 +23,8 @@
 #include <QMap>
 #include <QAction>
 
+#include <functional>
+
 #ifdef HAVE_QDBUS
     #include <QtDBus/QtDBus>
     #include "dbusaddressable.h"
@@ -30,17 +32,26 @@
 
 #include "terminalconfig.h"
 #include "properties.h"
+#include "tabregistry.h"
 
 class TabBar;
+class MainWindow;
 class TermWidgetHolder;
+class TermWidget;
 class QAction;
 class QActionGroup;
 class TabSwitcher;
+class QTimer;
 
 class TabWidget : public QTabWidget
 {
 Q_OBJECT
 public:
+    enum SortKey { SortByTitle, SortByDirectory, SortByActivity };
+    /*! Which terminals get what is typed into one of them: the others of
+        its tab, all of the window, or the ones selected by the user. */
+    enum BroadcastMode { BroadcastOff, BroadcastTab, BroadcastAllTabs, BroadcastSelection };
+
     TabWidget(QWidget* parent = nullptr);
     ~TabWidget() override;
 
@@ -48,9 +59,41 @@ public:
 
     void showHideTabBar();
     const QList<QWidget*>& history() const;
+    int tabIndex(const QWidget *holder) const;
 
     bool hasRunningProcess() const;
 
+    /*! Closes all tabs matching the predicate in a single pass. The last
+        tab is never closed. Returns the number of closed tabs.
+     */
+    int closeTabsIf(const std::function<bool(int)>& predicate, bool prompt);
+    int closeOtherTabs(int index);
+    int closeTabsToRight(int index);
+    int closeIdleTabs();
+    void sortTabs(SortKey key);
+
+    void setCustomTabTitle(int index, const QString &text);
+
+    /*! Tabs and single terminals move to other windows with their
+        programs running. Return the index of the tab in \a target.
+     */
+    int moveTabTo(int index, TabWidget *target, int targetIndex = -1);
+    int moveTerminalToNewTab(TermWidget *term, TabWidget *target);
+    // nullptr for the only tab, which has a window of its own already
+    MainWindow *moveTabToNewWindow(int index, const QPoint &pos = QPoint());
+
+    void setBroadcastMode(BroadcastMode mode);
+    BroadcastMode broadcastMode() const { return mBroadcastMode; }
+    // the tabs with their titles and split layouts
+    QVariantList session() const;
+    void restoreSession(const QVariantList &tabs, int current);
+    /*! Adds tabs described like those of a session in one pass, the
+        terminals starting when they are shown. Nothing is added if a
+        layout is not valid. \a replaceFirst reuses the first tab of a
+        new window.
+     */
+    QList<TermWidgetHolder*> addTabs(const QVariantList &tabs, bool replaceFirst = false);
+
 public slots:
     int addNewTab(TerminalConfig cfg);
     void removeTab(int index, bool prompt = false);
@@ -75,6 +118,10 @@ public slots:
     void splitHorizontally();
     void splitVertically();
     void splitCollapse();
+    void toggleBroadcastSelection();
+    void toggleMaximizedSubterminal();
+    void moveSubterminalToNewTab();
+    void moveCurrentTabToNewWindow();
 
     void copySelection();
     void pasteClipboard();
@@ -90,8 +137,6 @@ public slots:
 
     void clearActiveTerminal();
 
-    void saveSession();
-    void loadSession();
 
     void preset2Horizontal();
     void preset2Vertical();
@@ -99,11 +144,21 @@ public slots:
 
     void switchToNext();
     void switchToPrev();
+    void findTab();
 signals:
     void closeLastTabNotification();
     void tabRenameRequested(int);
     void tabTitleColorChangeRequested(int);
     void currentTitleChanged(int);
+    /*! The title or the working directory of a tab may have changed */
+    void tabInfoChanged(QWidget *holder);
+    void tabOpened(QWidget *holder);
+    void tabClosed(QWidget *holder);
+    /*! Emitted only when the counts change; they drive the enabled
+        state of the window actions. */
+    void tabCountChanged(int count);
+    void currentTerminalCountChanged(int count);
+    void broadcastModeChanged(TabWidget::BroadcastMode mode);
 
 protected:
     enum Direction{Left = 1, Right};
@@ -115,19 +170,41 @@ protected:
         renaming or new tab opening
      */
     bool eventFilter(QObject *obj, QEvent *event) override;
+    void tabInserted(int index) override;
+    void tabRemoved(int index) override;
 protected slots:
-    void updateTabIndices();
+    void onTabMoved(int from, int to);
+    void onTerminalCountChanged(int count);
     void onTermTitleChanged(const QString& title, const QString& icon);
+    void hibernateIdleTabs();
+    void sampleOutput();
 
 private:
     int tabNumerator;
     /* re-order naming of the tabs then removeCurrentTab() */
     void renameTabsAfterRemove();
     int switchTo(int index);
+    void wakeTab(int index);
+    int insertHolder(TermWidgetHolder *holder, int index, const QString &label);
+    void startTabDrag();
+    void setIndicator(int index, TabRegistry::Indicator indicator);
+    void updateBroadcastMembers();
+    void broadcastInput(TermWidget *source, const QString &text);
+    QString tabToolTipText(int index) const;
 
     TabBar *mTabBar;
+    TabRegistry mTabs;
     QScopedPointer<TabSwitcher> mSwitcher;
     QList<QWidget*> mHistory;
+    QTimer *mHibernateTimer;
+    QTimer *mMeterTimer;
+    BroadcastMode mBroadcastMode;
+    bool mBroadcasting;
+    // closeTabsIf() is removing tabs and updates the rest once at the end
+    bool mClosingTabs;
+    // a tab dragged out of the bar leaves it for another window
+    QPoint mDragStart;
+    bool mTabPressed;
 
     QMetaObject::Connection mFocusConnection;
 };
@@ -19,7 +19,9 @@ TerminalConfig::TerminalConfig() = default;
 TerminalConfig::TerminalConfig(const TerminalConfig &cfg)
     : m_currentDirectory(cfg.m_currentDirectory),
       m_workingDirectory(cfg.m_workingDirectory),
-      m_shell(cfg.m_shell) {}
+      m_shell(cfg.m_shell),
+      m_lazy(cfg.m_lazy),
+      m_title(cfg.m_title) {}
 
 QString TerminalConfig::getWorkingDirectory()
 {
@@ -46,11 +48,21 @@ QStringList TerminalConfig::getShell()
     return QStringList();
 }
 
+QStringList TerminalConfig::getCommand() const
+{
+    return m_shell;
+}
+
 bool TerminalConfig::hasCommand() const
 {
     return !m_shell.isEmpty();
 }
 
+bool TerminalConfig::isLazy() const
+{
+    return m_lazy;
+}
+
 void TerminalConfig::setWorkingDirectory(const QString &val)
 {
     m_workingDirectory = val;
@@ -66,19 +78,36 @@ void TerminalConfig::provideCurrentDirectory(const QString &val)
     m_currentDirectory = val;
 }
 
+void TerminalConfig::setLazy(bool val)
+{
+    m_lazy = val;
+}
+
+QString TerminalConfig::getTitle() const
+{
+    return m_title;
+}
+
+void TerminalConfig::setTitle(const QString &val)
+{
+    m_title = val;
+}
+
 
 
 #if HAVE_QDBUS
 
 #define DBUS_ARG_WORKDIR "workingDirectory"
 #define DBUS_ARG_SHELL "shell"
+#define DBUS_ARG_LAZY "lazy"
+#define DBUS_ARG_TITLE "title"
 
 TerminalConfig TerminalConfig::fromDbus(const QHash<QString,QVariant> &termArgsConst, TermWidget *toSplit)
 {
     QHash<QString,QVariant> termArgs(termArgsConst);
     if (toSplit != nullptr && !termArgs.contains(QLatin1String(DBUS_ARG_WORKDIR)))
     {
-        termArgs[QLatin1String(DBUS_ARG_WORKDIR)] = QVariant(toSplit->impl()->workingDirectory());
+        termArgs[QLatin1String(DBUS_ARG_WORKDIR)] = QVariant(toSplit->workingDirectory());
     }
     return TerminalConfig::fromDbus(termArgs);
 }
@@ -108,7 +137,10 @@ TerminalConfig TerminalConfig::fromDbus(const QHash<QString,QVariant> &termArgs)
     if (termArgs.contains(QLatin1String(DBUS_ARG_SHELL))) {
         shell = variantToStringList(termArgs[QLatin1String(DBUS_ARG_SHELL)], shell);
     }
-    return TerminalConfig(wdir, shell);
+    TerminalConfig cfg(wdir, shell);
+    cfg.setLazy(termArgs.value(QLatin1String(DBUS_ARG_LAZY), false).toBool());
+    cfg.setTitle(termArgs.value(QLatin1String(DBUS_ARG_TITLE)).toString());
+    return cfg;
 }
 
 #endif
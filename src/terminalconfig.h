@@ -17,11 +17,18 @@ class TerminalConfig
 
         QString getWorkingDirectory();
         QStringList getShell();
+        // the command instead of the shell, empty if there is none
+        QStringList getCommand() const;
         bool hasCommand() const;
+        bool isLazy() const;
+        // shown as the title of the tab until the program sets one
+        QString getTitle() const;
 
         void setWorkingDirectory(const QString &val);
         void setShell(const QStringList &val);
         void provideCurrentDirectory(const QString &val);
+        void setLazy(bool val);
+        void setTitle(const QString &val);
 
         #ifdef HAVE_QDBUS
         static TerminalConfig fromDbus(const QHash<QString,QVariant> &termArgs);
@@ -34,6 +41,9 @@ class TerminalConfig
     	QString m_currentDirectory;
     	QString m_workingDirectory;
         QStringList m_shell;
+        // Start the shell only when the terminal is shown for the first time
+        bool m_lazy = false;
+        QString m_title;
 };
 
 #endif
@@ -16,17 +16,25 @@
  *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
  ***************************************************************************/
 
+#include <QBuffer>
 #include <QMenu>
-#include <QVBoxLayout>
+#include <QLabel>
 #include <QPainter>
 #include <QDesktopServices>
 #include <QMessageBox>
 #include <QAbstractButton>
 #include <QMouseEvent>
+#include <QDateTime>
 #include <cassert>
 
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
 #ifdef HAVE_QDBUS
     #include <QtDBus/QtDBus>
+    #include "tabwidget.h"
     #include "termwidgetholder.h"
     #include "terminaladaptor.h"
 #endif
@@ -40,9 +48,30 @@
 #include "config.h"
 #include "properties.h"
 #include "qterminalapp.h"
+#include "qterminalutils.h"
+#include "inputfeed.h"
+#include "outputtap.h"
+#include "outputmatcher.h"
+#include "historyrows.h"
+#include "signalthrottle.h"
 
 static int TermWidgetCount = 0;
 
+// approximate size of one cell of the in-memory scrollback
+static const int HISTORY_CELL_SIZE = 16;
+
+// one frame at 60 Hz
+static const int TITLE_UPDATE_INTERVAL = 16;
+// the kinds of state signals, each limited separately
+enum { TitleEvent, DirectoryEvent, ProcessEvent, BellEvent };
+// Every size change of a terminal is a SIGWINCH for its program, and
+// full screen programs redraw completely on each; while a pane is being
+// resized only the layout follows, the terminal once it stops
+static const int RESIZE_QUIET_PERIOD = 150;
+
+// the border of the terminals whose input is broadcast
+static const QColor BROADCAST_BORDER_COLOR(0xe0, 0x40, 0x30);
+
 
 TermWidgetImpl::TermWidgetImpl(TerminalConfig &cfg, QWidget * parent)
     : QTermWidget(0, parent)
@@ -201,16 +230,13 @@ void TermWidgetImpl::customContextMenuCall(const QPoint & pos)
     menu.addAction(actions[QStringLiteral(SPLIT_VERTICAL)]);
     // warning TODO/FIXME: disable the action when there is only one terminal
     menu.addAction(actions[QStringLiteral(SUB_COLLAPSE)]);
+    menu.addAction(actions[QStringLiteral(SUB_TO_NEW_TAB)]);
     menu.addSeparator();
     menu.addAction(actions[QStringLiteral(TOGGLE_MENU)]);
     menu.addAction(actions[QStringLiteral(TOGGLE_BOOKMARKS)]);
     menu.addAction(actions[QStringLiteral(HIDE_WINDOW_BORDERS)]);
     menu.addAction(actions[QStringLiteral(PREFERENCES)]);
 
-    // The disabled actions should be updated before showing the menu because
-    // the "Actions" menu of the main window may have not been shown yet.
-    mainWindow->updateDisabledActions();
-
     menu.exec(mapToGlobal(pos));
 }
 
@@ -245,7 +271,7 @@ void TermWidgetImpl::activateUrl(const QUrl & url, bool fromContextMenu) {
 }
 
 void TermWidgetImpl::bell() {
-    if (Properties::Instance()->audibleBell) {
+    if (Properties::Instance()->audibleBell && !QTerminalApp::Instance()->isHeadless()) {
 #ifdef HAVE_LIBCANBERRA
         if (!libcanberra_context) {
             ca_context_create (&libcanberra_context);
@@ -259,8 +285,20 @@ void TermWidgetImpl::bell() {
     }
 }
 
-bool TermWidget::eventFilter(QObject * /*obj*/, QEvent * ev)
+bool TermWidget::eventFilter(QObject * obj, QEvent * ev)
 {
+    if (m_broadcastMember && !m_userInput
+        && (ev->type() == QEvent::KeyPress || ev->type() == QEvent::InputMethod))
+    {
+        // Deliver the event right away, so that what the terminal sends while
+        // handling it is known to be user input and not e.g. a reply to a
+        // query of the running program.
+        m_userInput = true;
+        QCoreApplication::sendEvent(obj, ev);
+        m_userInput = false;
+        return true;
+    }
+
     if (ev->type() == QEvent::MouseButtonPress)
     {
         QMouseEvent *mev = static_cast<QMouseEvent*>(ev);
@@ -272,7 +310,7 @@ bool TermWidget::eventFilter(QObject * /*obj*/, QEvent * ev)
             }
             else
             {
-                impl()->pasteSelection();
+                pasteSelection();
             }
             return true;
         }
@@ -290,20 +328,309 @@ bool TermWidget::eventFilter(QObject * /*obj*/, QEvent * ev)
 TermWidget::TermWidget(TerminalConfig &cfg, QWidget *parent)
     : QWidget(parent)
     , DBusAddressable(QStringLiteral("/terminals"))
-    , m_term(new TermWidgetImpl(cfg, this))
-    , m_layout(new QVBoxLayout)
+    , m_term(nullptr)
     , m_border(palette().color(QPalette::Window))
+    , m_hibernated(false)
+    , m_config(cfg)
+    , m_titleTimer(new QTimer(this))
+    , m_resizeTimer(new QTimer(this))
+    , m_sizeOverlay(new QLabel(this))
+    , m_geometryHeld(false)
+    , m_userInput(false)
+    , m_broadcastMember(false)
+    , m_broadcastSelected(false)
+    , m_inputDecoder(QStringDecoder::Utf8)
+    , m_bytesDecoder(QStringDecoder::Utf8)
+    , m_droppedTapBytes(0)
+    , m_matchTimer(new QTimer(this))
+    , m_events(new SignalThrottle(this))
+    , m_stateTimer(new QTimer(this))
+    , m_lastForeground(-1)
 {
 
     #ifdef HAVE_QDBUS
     registerAdapter<TerminalAdaptor, TermWidget>(this);
     #endif
 
-    setFocusProxy(m_term);
+    m_titleTimer->setSingleShot(true);
+    m_titleTimer->setInterval(TITLE_UPDATE_INTERVAL);
+    connect(m_titleTimer, &QTimer::timeout, this, &TermWidget::applyTitle);
+
+    m_resizeTimer->setSingleShot(true);
+    m_resizeTimer->setInterval(RESIZE_QUIET_PERIOD);
+    connect(m_resizeTimer, &QTimer::timeout, this, &TermWidget::applyTerminalGeometry);
+
+    // patterns are matched once per turn of the event loop, not per chunk
+    m_matchTimer->setSingleShot(true);
+    m_matchTimer->setInterval(0);
+    connect(m_matchTimer, &QTimer::timeout, this, &TermWidget::checkWaiters);
+
+    // the directory and the foreground process are looked at after output
+    m_stateTimer->setSingleShot(true);
+    #ifdef HAVE_QDBUS
+    connect(m_stateTimer, &QTimer::timeout, this, &TermWidget::checkState);
+    #endif
+
+    m_sizeOverlay->setAutoFillBackground(true);
+    m_sizeOverlay->setBackgroundRole(QPalette::ToolTipBase);
+    m_sizeOverlay->setForegroundRole(QPalette::ToolTipText);
+    m_sizeOverlay->setMargin(6);
+    m_sizeOverlay->hide();
+
+    if (!cfg.isLazy())
+        materialize();
+
+    propertiesChanged();
+}
+
+TermWidget::~TermWidget()
+{
+    while (!m_waiters.isEmpty())
+        finishWaiter(0, false, QString());
+}
+
+TermWidgetImpl * TermWidget::impl()
+{
+    if (m_term == nullptr)
+        materialize();
+    return m_term;
+}
+
+QString TermWidget::workingDirectory()
+{
+    if (m_term == nullptr)
+        return m_config.getWorkingDirectory();
+    return m_term->workingDirectory();
+}
+
+void TermWidget::showEvent(QShowEvent * event)
+{
+    if (m_term == nullptr)
+        materialize();
+    QWidget::showEvent(event);
+}
+
+void TermWidget::updateMargins()
+{
+    if (Properties::Instance()->highlightCurrentTerminal || m_broadcastMember)
+        setContentsMargins(2, 2, 2, 2);
+    else
+        setContentsMargins(0, 0, 0, 0);
+    applyTerminalGeometry();
+}
+
+void TermWidget::setBroadcastMember(bool member)
+{
+    if (m_broadcastMember == member)
+        return;
+    m_broadcastMember = member;
+    updateMargins();
+    update();
+}
+
+void TermWidget::pasteClipboard()
+{
+    // only the input of a member is broadcast, as in eventFilter()
+    m_userInput = m_broadcastMember;
+    impl()->pasteClipboard();
+    m_userInput = false;
+}
+
+void TermWidget::pasteSelection()
+{
+    // only the input of a member is broadcast, as in eventFilter()
+    m_userInput = m_broadcastMember;
+    impl()->pasteSelection();
+    m_userInput = false;
+}
+
+void TermWidget::feedInput(int fd)
+{
+    InputFeed *feed = new InputFeed(fd, this);
+    // what the program has not read from its tty yet
+    feed->setBacklog([this] {
+        int queued = 0;
+        if (m_term == nullptr || ::ioctl(m_term->getPtySlaveFd(), FIONREAD, &queued) != 0)
+            return 0;
+        return queued;
+    });
+    connect(feed, &InputFeed::text, this, [this](const QString &text) {
+        impl()->sendText(text);
+    });
+    connect(feed, &InputFeed::finished, this, [this, feed] {
+        m_feeds.removeOne(feed);
+        feed->deleteLater();
+        if (!m_feeds.isEmpty())
+            m_feeds.constFirst()->start();
+    });
+    m_feeds.append(feed);
+    if (m_feeds.size() == 1)
+        feed->start();
+}
+
+int TermWidget::openOutputTap(bool timestamps, int bufferSize)
+{
+    int fds[2];
+    if (::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds) != 0)
+        return -1;
+    OutputTap *tap = new OutputTap(fds[0], timestamps, bufferSize, this);
+    connect(tap, &OutputTap::closed, this, [this, tap] {
+        m_droppedTapBytes += tap->droppedBytes();
+        m_taps.removeOne(tap);
+        tap->deleteLater();
+    });
+    m_taps.append(tap);
+    return fds[1];
+}
+
+qint64 TermWidget::droppedTapBytes() const
+{
+    qint64 dropped = m_droppedTapBytes;
+    for (const OutputTap *tap : m_taps)
+        dropped += tap->droppedBytes();
+    return dropped;
+}
+
+void TermWidget::startMatching()
+{
+    if (m_matcher == nullptr)
+        m_matcher = std::make_unique<OutputMatcher>();
+}
+
+bool TermWidget::waitForOutput(const QString &pattern, int timeout,
+                               const std::function<void(bool, const QString &)> &done, QString *error)
+{
+    const QRegularExpression re(pattern, QRegularExpression::MultilineOption);
+    if (!re.isValid())
+    {
+        if (error != nullptr)
+            *error = re.errorString();
+        return false;
+    }
+    startMatching();
+    QString text;
+    const bool matched = m_matcher->match(re, &text);
+    if (matched || timeout <= 0)
+    {
+        done(matched, text);
+        return true;
+    }
+
+    QTimer *timer = new QTimer(this);
+    timer->setSingleShot(true);
+    connect(timer, &QTimer::timeout, this, [this, timer] {
+        for (int i = 0; i < m_waiters.size(); ++i)
+        {
+            if (m_waiters.at(i).timer == timer)
+            {
+                finishWaiter(i, false, QString());
+                break;
+            }
+        }
+    });
+    m_waiters.append({re, done, timer});
+    timer->start(timeout);
+    return true;
+}
+
+void TermWidget::checkWaiters()
+{
+    for (int i = 0; i < m_waiters.size();)
+    {
+        QString matched;
+        if (m_matcher->match(m_waiters.at(i).pattern, &matched))
+            finishWaiter(i, true, matched);
+        else
+            ++i;
+    }
+}
+
+void TermWidget::finishWaiter(int index, bool matched, const QString &text)
+{
+    const TextWaiter waiter = m_waiters.takeAt(index);
+    // may be the one that timed out
+    waiter.timer->deleteLater();
+    waiter.done(matched, text);
+}
+
+void TermWidget::resizeEvent(QResizeEvent * event)
+{
+    QWidget::resizeEvent(event);
+    if (m_term == nullptr || m_geometryHeld)
+        return;
+
+    // a hidden pane gets a single resize when it is shown
+    if (!isVisible())
+    {
+        applyTerminalGeometry();
+        return;
+    }
+    m_resizeTimer->start();
+    updateSizeOverlay();
+}
+
+void TermWidget::flushResize()
+{
+    if (m_resizeTimer->isActive())
+        applyTerminalGeometry();
+}
+
+void TermWidget::setGeometryHeld(bool held)
+{
+    if (m_geometryHeld == held)
+        return;
+    m_geometryHeld = held;
+    if (!held)
+        m_resizeTimer->start();
+}
+
+void TermWidget::applyTerminalGeometry()
+{
+    m_resizeTimer->stop();
+    m_sizeOverlay->hide();
+    if (m_geometryHeld)
+        return;
+    if (m_term != nullptr && m_term->geometry() != contentsRect())
+        m_term->setGeometry(contentsRect());
+}
 
-    setLayout(m_layout);
+void TermWidget::updateSizeOverlay()
+{
+    if (!Properties::Instance()->showResizeOverlay)
+        return;
+
+    // the scrollbar and the margins of the display keep their size
+    const QFontMetrics fm(m_term->getTerminalFont());
+    const int charWidth = qMax(1, fm.horizontalAdvance(QLatin1Char('W')));
+    const int lineHeight = qMax(1, fm.height());
+    const int extraWidth = m_term->width() - m_term->screenColumnsCount() * charWidth;
+    const int extraHeight = m_term->height() - m_term->screenLinesCount() * lineHeight;
+    const int columns = qMax(1, (contentsRect().width() - extraWidth) / charWidth);
+    const int lines = qMax(1, (contentsRect().height() - extraHeight) / lineHeight);
+
+    m_sizeOverlay->setText(QStringLiteral("%1 \u00d7 %2").arg(columns).arg(lines));
+    m_sizeOverlay->adjustSize();
+    m_sizeOverlay->move((width() - m_sizeOverlay->width()) / 2, (height() - m_sizeOverlay->height()) / 2);
+    m_sizeOverlay->show();
+}
+
+QSize TermWidget::minimumSizeHint() const
+{
+    if (m_term == nullptr)
+        return QWidget::minimumSizeHint();
+    const QMargins margins = contentsMargins();
+    return m_term->minimumSizeHint().grownBy(margins);
+}
 
-    m_layout->addWidget(m_term);
+void TermWidget::materialize()
+{
+    const bool focused = hasFocus();
+
+    m_term = new TermWidgetImpl(m_config, this);
+    setFocusProxy(m_term);
+    m_term->setGeometry(contentsRect());
+    m_term->show();
+    m_sizeOverlay->raise();
     const auto objs = m_term->children();
 
     for (QObject *o : objs)
@@ -316,22 +643,101 @@ TermWidget::TermWidget(TerminalConfig &cfg, QWidget *parent)
         o->installEventFilter(this);
     }
 
-    propertiesChanged();
-
     connect(m_term, &QTermWidget::finished, this, &TermWidget::finished);
     connect(m_term, &QTermWidget::termGetFocus, this, &TermWidget::term_termGetFocus);
     connect(m_term, &QTermWidget::termLostFocus, this, &TermWidget::term_termLostFocus);
-    connect(m_term, &QTermWidget::titleChanged, this, [this] { emit termTitleChanged(m_term->title(), m_term->icon()); });
+    // receivedData() carries the raw bytes as Latin-1, one character per byte
+    connect(m_term, &QTermWidget::receivedData, this, [this](const QString &text) {
+        if (m_meter.countsLines())
+            m_meter.add(text.size(), text.count(QLatin1Char('\n')));
+        else
+            m_meter.add(text.size());
+        #ifdef HAVE_QDBUS
+        if (!m_stateTimer->isActive())
+            m_stateTimer->start();
+        #endif
+        if (m_taps.isEmpty() && m_matcher == nullptr)
+            return;
+        const QByteArray data = text.toLatin1();
+        const qint64 now = QDateTime::currentMSecsSinceEpoch();
+        for (OutputTap *tap : std::as_const(m_taps))
+            tap->write(data, now);
+        if (m_matcher != nullptr)
+        {
+            m_matcher->append(data);
+            if (!m_matchTimer->isActive())
+                m_matchTimer->start();
+        }
+    });
+    connect(m_term, &QTermWidget::sendData, this, [this](const char *data, int len) {
+        // decoded once here, the broadcast sends the same text to every member
+        if (m_userInput)
+            emit userInput(this, m_inputDecoder.decode(QByteArrayView(data, len)));
+    });
+    #ifdef HAVE_QDBUS
+    connect(m_term, &QTermWidget::bell, this, [this] {
+        m_events->post(BellEvent, [this] { emit bell(); });
+    });
+    #endif
+    connect(m_term, &QTermWidget::titleChanged, this, [this] {
+        // not restarted while pending, so continuous changes still get through
+        if (!m_titleTimer->isActive())
+            m_titleTimer->start();
+    });
+
+    if (focused)
+        m_term->setFocus(Qt::OtherFocusReason);
 }
 
 void TermWidget::propertiesChanged()
 {
-    if (Properties::Instance()->highlightCurrentTerminal)
-        m_layout->setContentsMargins(2, 2, 2, 2);
-    else
-        m_layout->setContentsMargins(0, 0, 0, 0);
-
+    updateMargins();
+    m_events->setInterval(Properties::Instance()->dbusSignalInterval);
+    m_stateTimer->setInterval(qMax(Properties::Instance()->dbusSignalInterval, TITLE_UPDATE_INTERVAL));
+    if (m_term == nullptr)
+        return;
     m_term->propertiesChanged();
+    if (m_hibernated)
+        applyHibernation();
+}
+
+qint64 TermWidget::hibernate()
+{
+    // a pending terminal has nothing to release
+    if (m_hibernated || m_term == nullptr)
+        return 0;
+    m_hibernated = true;
+
+    // an unlimited history is file based already
+    qint64 released = 0;
+    if (Properties::Instance()->historyLimited)
+        released = qint64(m_term->historyLinesCount()) * m_term->screenColumnsCount() * HISTORY_CELL_SIZE;
+
+    applyHibernation();
+    return released;
+}
+
+void TermWidget::applyHibernation()
+{
+    m_term->setUpdatesEnabled(false);
+    m_term->setBlinkingCursor(false);
+    // a negative size switches to the file based history, which takes
+    // over the current lines
+    if (Properties::Instance()->historyLimited)
+        m_term->setHistorySize(-1);
+}
+
+void TermWidget::wake()
+{
+    if (!m_hibernated)
+        return;
+    m_hibernated = false;
+
+    if (Properties::Instance()->historyLimited)
+        m_term->setHistorySize(Properties::Instance()->historyLimitedTo);
+    m_term->setBlinkingCursor(Properties::Instance()->keyboardCursorBlink);
+    m_term->setUpdatesEnabled(true);
+    m_term->update();
 }
 
 void TermWidget::term_termGetFocus()
@@ -341,6 +747,21 @@ void TermWidget::term_termGetFocus()
     update();
 }
 
+void TermWidget::applyTitle()
+{
+    // only the latest title counts; skip it if nothing changed since the last one
+    const QString title = m_term->title();
+    const QString icon = m_term->icon();
+    if (title == m_title && icon == m_icon)
+        return;
+    m_title = title;
+    m_icon = icon;
+    emit termTitleChanged(title, icon);
+    #ifdef HAVE_QDBUS
+    m_events->post(TitleEvent, [this, title] { emit titleChanged(title); });
+    #endif
+}
+
 void TermWidget::term_termLostFocus()
 {
     m_border = palette().color(QPalette::Window);
@@ -349,12 +770,13 @@ void TermWidget::term_termLostFocus()
 
 void TermWidget::paintEvent (QPaintEvent *)
 {
-  if (Properties::Instance()->highlightCurrentTerminal)
+  if (Properties::Instance()->highlightCurrentTerminal || m_broadcastMember)
     {
+      const QColor border = m_broadcastMember ? BROADCAST_BORDER_COLOR : m_border;
       QPainter p(this);
-      QPen pen(m_border);
+      QPen pen(border);
       pen.setWidth(3);
-      pen.setBrush(m_border);
+      pen.setBrush(border);
       p.setPen(pen);
       p.drawRect(0, 0, width()-1, height()-1);
     }
@@ -391,10 +813,186 @@ void TermWidget::closeTerminal()
 
 void TermWidget::sendText(const QString& text)
 {
+    startMatching();
     if (impl())
     {
         impl()->sendText(text);
     }
 }
 
+void TermWidget::sendFd(const QDBusUnixFileDescriptor &fd)
+{
+    startMatching();
+    // the descriptor of the message goes away with the message
+    const int own = ::fcntl(fd.fileDescriptor(), F_DUPFD_CLOEXEC, 0);
+    if (own >= 0)
+        feedInput(own);
+}
+
+void TermWidget::sendBytes(const QByteArray &data)
+{
+    startMatching();
+    // a character may be split between two calls
+    const QString text = m_bytesDecoder.decode(data);
+    if (!text.isEmpty())
+        impl()->sendText(text);
+}
+
+QDBusUnixFileDescriptor TermWidget::tapOutput(const QVariantMap &options)
+{
+    const bool timestamps = options.value(QStringLiteral("timestamps")).toBool();
+    const int bufferSize = options.value(QStringLiteral("bufferSize"), OutputTap::DefaultBufferSize).toInt();
+    const int fd = openOutputTap(timestamps, qBound(4096, bufferSize, 64 * 1024 * 1024));
+    if (fd < 0)
+        return QDBusUnixFileDescriptor();
+    // the message takes a copy
+    QDBusUnixFileDescriptor result(fd);
+    ::close(fd);
+    return result;
+}
+
+void TermWidget::setMaximized(bool maximized)
+{
+    TermWidgetHolder *holder = findParent<TermWidgetHolder>(this);
+    if (maximized)
+        holder->maximizeTerminal(this);
+    else if (holder->maximizedTerminal() == this)
+        holder->restoreMaximized();
+}
+
+bool TermWidget::isMaximized()
+{
+    return findParent<TermWidgetHolder>(this)->maximizedTerminal() == this;
+}
+
+QVariantMap TermWidget::getOutputStats()
+{
+    QVariantList history;
+    const auto samples = m_meter.history();
+    for (const qint64 bytes : samples)
+        history.append(bytes);
+
+    QVariantMap stats;
+    stats[QStringLiteral("totalBytes")] = m_meter.totalBytes();
+    stats[QStringLiteral("totalLines")] = m_meter.totalLines();
+    stats[QStringLiteral("bytesPerSecond")] = m_meter.bytesPerSecond();
+    stats[QStringLiteral("linesPerSecond")] = m_meter.linesPerSecond();
+    stats[QStringLiteral("msecsSinceOutput")] = m_meter.msecsSinceOutput(QDateTime::currentMSecsSinceEpoch());
+    stats[QStringLiteral("history")] = history;
+    stats[QStringLiteral("droppedTapBytes")] = droppedTapBytes();
+    return stats;
+}
+
+QByteArray TermWidget::getScreenshot()
+{
+    QByteArray png;
+    QBuffer buffer(&png);
+    buffer.open(QIODevice::WriteOnly);
+    impl()->grab().save(&buffer, "PNG");
+    return png;
+}
+
+QString TermWidget::getScreenText()
+{
+    if (m_term == nullptr)
+        return QString();
+    return getLines(-m_term->screenLinesCount(), m_term->screenLinesCount()).join(QLatin1Char('\n'));
+}
+
+QStringList TermWidget::getLines(int first, int count)
+{
+    // a lazy terminal has no output yet
+    if (m_term == nullptr)
+        return QStringList();
+
+    // only the rows asked for are kept while the history streams through
+    HistoryRows rows(m_term->screenColumnsCount(), first, count);
+    m_term->saveHistory(&rows);
+    return rows.rows();
+}
+
+void TermWidget::checkState()
+{
+    if (m_term == nullptr)
+        return;
+    const QString directory = m_term->workingDirectory();
+    if (directory != m_lastDirectory)
+    {
+        m_lastDirectory = directory;
+        m_events->post(DirectoryEvent, [this, directory] { emit workingDirectoryChanged(directory); });
+    }
+    const int foreground = m_term->getForegroundProcessId();
+    if (foreground != m_lastForeground)
+    {
+        m_lastForeground = foreground;
+        const QString name = process_name(foreground);
+        m_events->post(ProcessEvent, [this, foreground, name] { emit foregroundProcessChanged(foreground, name); });
+    }
+}
+
+bool TermWidget::waitFor(const QString &pattern, int timeout, QString &text)
+{
+    Q_UNUSED(text);
+    // there is no message to reply to later otherwise, see waitForOutput()
+    if (!calledFromDBus())
+        return false;
+    // the reply is sent when the output matches or the time is up
+    setDelayedReply(true);
+    const QDBusMessage call = message();
+    // replied on the connection the call came from
+    const QDBusConnection bus = connection();
+    QString error;
+    if (!waitForOutput(pattern, timeout, [call, bus](bool matched, const QString &matchedText) {
+            bus.send(call.createReply(QVariantList{matched, matchedText}));
+        }, &error))
+    {
+        sendErrorReply(QDBusError::InvalidArgs, error);
+    }
+    return false;
+}
+
+void TermWidget::moveToTab(const QDBusObjectPath &tab, bool topBottom)
+{
+    TermWidgetHolder *holder = findParent<TermWidgetHolder>(this);
+    TermWidgetHolder *target = findDbusObject<TermWidgetHolder>(tab);
+    if (target == nullptr || target == holder)
+        return;
+    holder->takeTerminal(this);
+    target->insertTerminal(this, nullptr, topBottom ? Qt::Vertical : Qt::Horizontal);
+}
+
+QDBusObjectPath TermWidget::moveToNewTab(const QDBusObjectPath &window)
+{
+    // the own window unless another one is given
+    MainWindow *target = findDbusObject<MainWindow>(window);
+    if (target == nullptr)
+        target = findParent<MainWindow>(this);
+    findParent<TabWidget>(this)->moveTerminalToNewTab(this, target->tabWidget());
+    return findParent<TermWidgetHolder>(this)->getDbusPath();
+}
+
+QVariantMap TermWidget::describe()
+{
+    QVariantMap info;
+    info[QStringLiteral("path")] = QVariant::fromValue(getDbusPath());
+    info[QStringLiteral("cwd")] = workingDirectory();
+    info[QStringLiteral("pending")] = isPending();
+    info[QStringLiteral("hibernated")] = m_hibernated;
+    // a lazy terminal stays one, it has no processes or size yet
+    if (m_term == nullptr)
+    {
+        info[QStringLiteral("title")] = m_config.getTitle();
+        return info;
+    }
+    const int foreground = m_term->getForegroundProcessId();
+    info[QStringLiteral("title")] = m_term->title();
+    info[QStringLiteral("shellPid")] = m_term->getShellPID();
+    info[QStringLiteral("foregroundPid")] = foreground;
+    info[QStringLiteral("foregroundProcess")] = process_name(foreground);
+    info[QStringLiteral("columns")] = m_term->screenColumnsCount();
+    info[QStringLiteral("lines")] = m_term->screenLinesCount();
+    info[QStringLiteral("historyLines")] = m_term->historyLinesCount();
+    return info;
+}
+
 #endif
@@ -22,10 +22,23 @@
 #include <qtermwidget6/qtermwidget.h>
 
 #include "terminalconfig.h"
+#include "outputmeter.h"
 
 #include <QAction>
+#include <QRegularExpression>
+#include <QTimer>
+#include <QStringDecoder>
 #include "dbusaddressable.h"
 
+#include <functional>
+#include <memory>
+
+class QLabel;
+class InputFeed;
+class OutputTap;
+class OutputMatcher;
+class SignalThrottle;
+
 #ifdef HAVE_LIBCANBERRA
 // forwarded declaration from <canberra.h>
 struct ca_context;
@@ -70,27 +83,164 @@ class TermWidgetImpl : public QTermWidget
 
 
 class TermWidget : public QWidget, public DBusAddressable
+#ifdef HAVE_QDBUS
+    , protected QDBusContext
+#endif
 {
     Q_OBJECT
 
     TermWidgetImpl * m_term;
-    QVBoxLayout * m_layout;
     QColor m_border;
+    bool m_hibernated;
+    // kept until the terminal is materialized
+    TerminalConfig m_config;
+    // title changes are applied at most once per frame
+    QTimer * m_titleTimer;
+    QString m_title;
+    QString m_icon;
+    OutputMeter m_meter;
+    // the terminal follows the size of the pane once resizing settles
+    QTimer * m_resizeTimer;
+    QLabel * m_sizeOverlay;
+    bool m_geometryHeld;
+    // input broadcasting
+    bool m_userInput;
+    bool m_broadcastMember;
+    bool m_broadcastSelected;
+    QStringDecoder m_inputDecoder;
+    // fed one after the other, the first one is running
+    QList<InputFeed*> m_feeds;
+    QStringDecoder m_bytesDecoder;
+    QList<OutputTap*> m_taps;
+    // of the taps that have been closed
+    qint64 m_droppedTapBytes;
+    // output since a script started to talk to the terminal, see waitFor()
+    std::unique_ptr<OutputMatcher> m_matcher;
+    QTimer * m_matchTimer;
+    // state changes announced on D-Bus, at most once per interval
+    SignalThrottle * m_events;
+    QTimer * m_stateTimer;
+    QString m_lastDirectory;
+    int m_lastForeground;
+    #ifdef HAVE_QDBUS
+    void checkState();
+    #endif
+    struct TextWaiter {
+        QRegularExpression pattern;
+        std::function<void(bool, const QString &)> done;
+        QTimer *timer;
+    };
+    QList<TextWaiter> m_waiters;
+    void startMatching();
+    void checkWaiters();
+    void finishWaiter(int index, bool matched, const QString &text);
+
+    void materialize();
+    void applyHibernation();
+    void updateSizeOverlay();
+    void updateMargins();
 
     public:
         TermWidget(TerminalConfig &cfg, QWidget * parent=nullptr);
+        ~TermWidget() override;
 
         void propertiesChanged();
-        QStringList availableKeyBindings() { return m_term->availableKeyBindings(); }
+        QStringList availableKeyBindings() { return QTermWidget::availableKeyBindings(); }
+
+        /*! The terminal itself. A lazy terminal is a placeholder until it
+            is shown or used for the first time; calling impl() starts its
+            shell. Use isPending() where that is not wanted.
+         */
+        TermWidgetImpl * impl();
+        bool isPending() const { return m_term == nullptr; }
+        QString workingDirectory();
+        const TerminalConfig & config() const { return m_config; }
+
+        /*! Hibernation of a terminal in an idle background tab.
+            The shell keeps running, but the display stops repainting and
+            the scrollback is moved out of memory until wake() is called.
+            Returns an estimate of the released memory in bytes.
+         */
+        qint64 hibernate();
+        void wake();
+        bool isHibernated() const { return m_hibernated; }
+
+        OutputMeter & outputMeter() { return m_meter; }
+
+        /*! Gives the terminal the size of the pane now instead of after the
+            quiet period, e.g. when a splitter handle is released.
+         */
+        void flushResize();
 
-        TermWidgetImpl * impl() { return m_term; }
+        /*! While the terminal moves to another tab or window, its pty
+            keeps the old size. Released, the terminal takes the size of
+            its new pane once the layout there has settled.
+         */
+        void setGeometryHeld(bool held);
+
+        /*! Members of the active broadcast group get a border, and what the
+            user types or pastes into them is emitted as userInput().
+         */
+        void setBroadcastMember(bool member);
+        bool isBroadcastMember() const { return m_broadcastMember; }
+        void setBroadcastSelected(bool selected) { m_broadcastSelected = selected; }
+        bool isBroadcastSelected() const { return m_broadcastSelected; }
+
+        /*! Types what is read from \a fd, which it takes over, into the
+            terminal at the pace of the program running in it.
+         */
+        void feedInput(int fd);
+
+        /*! Opens a tap on the output of the terminal and returns the
+            reading end of it, which the caller owns, or -1.
+            See OutputTap for the format.
+         */
+        int openOutputTap(bool timestamps, int bufferSize);
+        qint64 droppedTapBytes() const;
+
+        /*! Calls \a done once \a pattern matches the output, or with false
+            after \a timeout msecs, see waitFor(). Returns false and sets
+            \a error if the pattern is invalid.
+         */
+        bool waitForOutput(const QString &pattern, int timeout,
+                           const std::function<void(bool matched, const QString &text)> &done,
+                           QString *error = nullptr);
+
+        void pasteClipboard();
+        void pasteSelection();
+        QSize minimumSizeHint() const override;
 
         #ifdef HAVE_QDBUS
         QDBusObjectPath splitHorizontal(const QHash<QString,QVariant> &termArgs);
         QDBusObjectPath splitVertical(const QHash<QString,QVariant> &termArgs);
         QDBusObjectPath getTab();
         void sendText(const QString& text);
+        void sendFd(const QDBusUnixFileDescriptor &fd);
+        void sendBytes(const QByteArray &data);
+        QDBusUnixFileDescriptor tapOutput(const QVariantMap &options);
         void closeTerminal();
+        void setMaximized(bool maximized);
+        bool isMaximized();
+        QVariantMap getOutputStats();
+        // a PNG of the terminal, rendered for the call if it is not on screen
+        QByteArray getScreenshot();
+        // the rows on screen
+        QString getScreenText();
+        /*! Rows of scrollback and screen, oldest first, numbered as in
+            historyLinesCount(); a negative \a first counts from the end.
+            Wrapped lines are split at the current width, see HistoryRows.
+         */
+        QStringList getLines(int first, int count);
+        /*! Replies once \a pattern matches the output, or with false after
+            \a timeout msecs. The output counts from the first text sent over
+            D-Bus or the first call of waitFor(), and a match consumes it up
+            to its end, like expect does.
+         */
+        bool waitFor(const QString &pattern, int timeout, QString &text);
+        void moveToTab(const QDBusObjectPath &tab, bool topBottom);
+        QDBusObjectPath moveToNewTab(const QDBusObjectPath &window);
+        // path, title, processes and size, for QTerminalApp::describeAll()
+        QVariantMap describe();
         #endif
 
         bool eventFilter(QObject * obj, QEvent * evt) override;
@@ -104,6 +254,14 @@ class TermWidget : public QWidget, public DBusAddressable
         void splitCollapse(TermWidget * self);
         void termGetFocus(TermWidget * self);
         void termTitleChanged(QString titleText, QString icon);
+        void userInput(TermWidget * self, const QString & text);
+        #ifdef HAVE_QDBUS
+        // relayed by the D-Bus adaptor
+        void titleChanged(const QString & title);
+        void workingDirectoryChanged(const QString & directory);
+        void foregroundProcessChanged(int pid, const QString & name);
+        void bell();
+        #endif
 
     public slots:
 
@@ -113,10 +271,14 @@ class TermWidget : public QWidget, public DBusAddressable
             return false;
         }
         void paintEvent (QPaintEvent * event) override;
+        void showEvent(QShowEvent * event) override;
+        void resizeEvent(QResizeEvent * event) override;
 
     private slots:
+        void applyTerminalGeometry();
         void term_termGetFocus();
         void term_termLostFocus();
+        void applyTitle();
 };
 
 #endif
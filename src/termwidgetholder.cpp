@@ -31,16 +31,18 @@
 #include "termwidget.h"
 #include "properties.h"
 #include <cassert>
-#include <climits>
 #include <algorithm>
 #include <utility>
 
 
-TermWidgetHolder::TermWidgetHolder(TerminalConfig &config, QWidget * parent)
+TermWidgetHolder::TermWidgetHolder(QWidget * parent)
     : QWidget(parent)
       #ifdef HAVE_QDBUS
       , DBusAddressable(QStringLiteral("/tabs"))
       #endif
+      , m_terminalCount(0)
+      , m_maximized(nullptr)
+      , m_placeholder(nullptr)
 {
     #ifdef HAVE_QDBUS
     new TabAdaptor(this);
@@ -51,82 +53,135 @@ TermWidgetHolder::TermWidgetHolder(TerminalConfig &config, QWidget * parent)
     lay->setSpacing(0);
     lay->setContentsMargins(0, 0, 0, 0);
 
-    QSplitter *s = new QSplitter(this);
-    s->setFocusPolicy(Qt::NoFocus);
-    TermWidget *w = newTerm(config);
-    s->addWidget(w);
+    QSplitter *s = newSplitter(Qt::Horizontal);
+    m_tree.setObject(m_tree.root(), s);
     lay->addWidget(s);
-    m_currentTerm = w;
+    m_currentTerm = nullptr;
 
     setLayout(lay);
 }
 
+TermWidgetHolder::TermWidgetHolder(TerminalConfig &config, QWidget * parent)
+    : TermWidgetHolder(parent)
+{
+    TermWidget *w = newTerm(config);
+    syncBranch(m_tree.append(w).branch);
+    m_currentTerm = w;
+}
+
+TermWidgetHolder::TermWidgetHolder(TermWidget * term, QWidget * parent)
+    : TermWidgetHolder(parent)
+{
+    adoptTerm(term);
+    syncBranch(m_tree.append(term).branch);
+    // a new tab is not hibernated, whatever the one the terminal came from was
+    term->wake();
+    term->show();
+    term->setGeometryHeld(false);
+    m_currentTerm = term;
+}
+
 TermWidgetHolder::~TermWidgetHolder() = default;
 
 void TermWidgetHolder::setInitialFocus()
 {
-    QList<TermWidget*> list = findChildren<TermWidget*>();
-    TermWidget * w = list.count() == 0 ? 0 : list.at(0);
+    TermWidget * w = static_cast<TermWidget*>(m_tree.firstLeaf(m_tree.root()));
     if (w)
         w->setFocus(Qt::OtherFocusReason);
 }
 
-void TermWidgetHolder::loadSession()
+QVariant TermWidgetHolder::layout() const
 {
-    bool ok = false;
-    QString name = QInputDialog::getItem(this, tr("Load Session"),
-                                         tr("List of saved sessions:"),
-                                         Properties::Instance()->sessions.keys(),
-                                         0, false, &ok);
-    if (!ok || name.isEmpty())
-        return;
-#if 0
-    foreach (QWidget * w, findChildren<QWidget*>())
+    return m_tree.toVariant([](QObject *leaf) {
+        TermWidget *term = static_cast<TermWidget*>(leaf);
+        QVariantMap terminal;
+        terminal[QStringLiteral("workingDirectory")] = term->workingDirectory();
+        if (term->config().hasCommand())
+            terminal[QStringLiteral("command")] = term->config().getCommand();
+        if (!term->config().getTitle().isEmpty())
+            terminal[QStringLiteral("title")] = term->config().getTitle();
+        return QVariant(terminal);
+    });
+}
+
+bool TermWidgetHolder::restoreLayout(const QVariant &layout)
+{
+    restoreMaximized();
+    const QList<QObject*> oldTerminals = m_tree.leaves();
+    const QList<QObject*> oldSplitters = m_tree.branches();
+
+    // The whole tree is built first, so every widget is parented only once.
+    // The shells start when their terminals are shown for the first time.
+    const bool ok = m_tree.fromVariant(layout, [this](const QVariant &data) -> QObject* {
+        const QVariantMap terminal = data.toMap();
+        TerminalConfig cfg;
+        cfg.setWorkingDirectory(terminal.value(QStringLiteral("workingDirectory")).toString());
+        // "shell" as in the arguments of the D-Bus methods
+        cfg.setShell(terminal.value(QStringLiteral("command"), terminal.value(QStringLiteral("shell"))).toStringList());
+        cfg.setTitle(terminal.value(QStringLiteral("title")).toString());
+        cfg.setLazy(true);
+        return newTerm(cfg);
+    });
+    if (!ok)
+        return false;
+
+    syncBranch(m_tree.root());
+    m_currentTerm = static_cast<TermWidget*>(m_tree.firstLeaf(m_tree.root()));
+    for (QObject *term : oldTerminals)
+        delete term;
+    qDeleteAll(oldSplitters);
+    m_terminalCount = m_tree.count();
+    m_panes.invalidate();
+    emit terminalCountChanged(m_terminalCount);
+
+    m_currentTerm->setFocus(Qt::OtherFocusReason);
+    if (!m_currentTerm->config().getTitle().isEmpty())
+        emit termTitleChanged(m_currentTerm->config().getTitle(), QString{});
+    return true;
+}
+
+QSplitter *TermWidgetHolder::newSplitter(Qt::Orientation orientation)
+{
+    QSplitter *s = new QSplitter(orientation, this);
+    s->setFocusPolicy(Qt::NoFocus);
+    connect(s, &QSplitter::splitterMoved, this, [this, s] {
+        if (SplitTree::Node *branch = m_tree.node(s))
+            m_tree.setSizes(branch, s->sizes());
+    });
+    return s;
+}
+
+QSplitter *TermWidgetHolder::syncBranch(SplitTree::Node *branch)
+{
+    QSplitter *s = static_cast<QSplitter*>(branch->object);
+    if (s == nullptr)
     {
-        if (w)
-        {
-            delete w;
-            w = 0;
-        }
+        s = newSplitter(branch->orientation);
+        m_tree.setObject(branch, s);
     }
+    s->setOrientation(branch->orientation);
 
-    qDebug() << "load" << name << QString(Properties::Instance()->sessions[name]);
-    QStringList splitters = QString(Properties::Instance()->sessions[name]).split("|", QString::SkipEmptyParts);
-    foreach (QString splitter, splitters)
+    for (int i = 0; i < branch->children.size(); ++i)
     {
-        QStringList components = splitter.split(",");
-        qDebug() << "comp" << components;
-        // orientation
-        Qt::Orientation orientation;
-        if (components.size() > 0)
-            orientation = components.takeAt(0).toInt();
-        // sizes
-        QList<int> sizes;
-        QList<TermWidget*> widgets;
-        foreach (QString s, components)
-        {
-            sizes << s.toInt();
-            widgets << newTerm();
-        }
-        // new terms
+        SplitTree::Node *child = branch->children.at(i);
+        QWidget *w = child->object != nullptr ? static_cast<QWidget*>(child->object) : syncBranch(child);
+        if (s->indexOf(w) != i)
+            s->insertWidget(i, w);
     }
-#endif
+    s->setSizes(m_tree.sizes(branch));
+    for (int i = 1; i < s->count(); ++i)
+        s->handle(i)->installEventFilter(this);
+    return s;
 }
 
-void TermWidgetHolder::saveSession(const QString & name)
+QList<TermWidget*> TermWidgetHolder::terminals() const
 {
-    Session dump;
-    QString num(QLatin1String("%1"));
-    const auto ws = findChildren<QSplitter*>();
-    for(QSplitter *w : ws)
-    {
-        dump += QLatin1Char('|') + num.arg(w->orientation());
-        const auto sizes = w->sizes();
-        for (const int i : sizes)
-            dump += QLatin1Char(',') + num.arg(i);
-    }
-    Properties::Instance()->sessions[name] = dump;
-    qDebug() << "dump" << dump;
+    QList<TermWidget*> terminals;
+    const auto leaves = m_tree.leaves();
+    terminals.reserve(leaves.size());
+    for (QObject *leaf : leaves)
+        terminals.append(static_cast<TermWidget*>(leaf));
+    return terminals;
 }
 
 TermWidget* TermWidgetHolder::currentTerminal()
@@ -139,119 +194,110 @@ void TermWidgetHolder::setWDir(const QString & wdir)
     m_wdir = wdir;
 }
 
-typedef struct  {
-    QPoint topLeft;
-    QPoint middle;
-    QPoint bottomRight;
-} NavigationData;
-
-static void transpose(QPoint *point) {
-    int x = point->x();
-    point->setX(point->y());
-    point->setY(x);
-}
-
-static void transposeTransform(NavigationData *point) {
-    transpose(&point->topLeft);
-    transpose(&point->middle);
-    transpose(&point->bottomRight);
-}
-
-static void flipTransform(NavigationData *point) {
-    QPoint oldTopLeft = point->topLeft;
-    point->topLeft = -(point->bottomRight);
-    point->bottomRight = -(oldTopLeft);
-    point->middle = -(point->middle);
-}
-
-static void normalizeToRight(NavigationData *point, NavigationDirection dir) {
-    switch (dir) {
-        case Left:
-            flipTransform(point);
-            break;
-        case Right:
-            // No-op
-            break;
-        case Top:
-            flipTransform(point);
-            transposeTransform(point);
-            break;
-        case Bottom:
-            transposeTransform(point);
-            break;
-        default:
-            assert("Invalid navigation");
-            return;
+bool TermWidgetHolder::eventFilter(QObject *obj, QEvent *event)
+{
+    // splitter moves and relayouts reach the panes as moves and resizes
+    if (event->type() == QEvent::Move || event->type() == QEvent::Resize)
+        m_panes.invalidate();
+
+    // the drag of a splitter handle is over, no need to wait for the panes
+    if (event->type() == QEvent::MouseButtonRelease && qobject_cast<QSplitterHandle*>(obj))
+    {
+        const auto terminals = m_tree.leaves();
+        for (QObject *term : terminals)
+            static_cast<TermWidget*>(term)->flushResize();
     }
+    return QWidget::eventFilter(obj, event);
 }
 
-static NavigationData getNormalizedDimensions(QWidget *w, NavigationDirection dir) {
-    NavigationData nd;
-    nd.topLeft = w->mapTo(w->window(), QPoint(0, 0));
-    nd.middle = w->mapTo(w->window(), QPoint(w->width() / 2, w->height() / 2));
-    nd.bottomRight = w->mapTo(w->window(), QPoint(w->width(), w->height()));
-    normalizeToRight(&nd, dir);
-    return nd;
+void TermWidgetHolder::resizeEvent(QResizeEvent *event)
+{
+    m_panes.invalidate();
+    QWidget::resizeEvent(event);
 }
 
+void TermWidgetHolder::updatePanes()
+{
+    if (m_panes.isValid())
+        return;
 
-void TermWidgetHolder::directionalNavigation(NavigationDirection dir) {
-    // Find an active widget
-    QList<TermWidget*> l = findChildren<TermWidget*>();
-    int ix = -1;
-    for (TermWidget * w : std::as_const(l))
+    QList<PaneIndex::Pane> panes;
+    const auto terminals = m_tree.leaves();
+    for (QObject *leaf : terminals)
     {
-        ++ix;
-        if (w->impl()->hasFocus())
-        {
-            break;
-        }
+        TermWidget *w = static_cast<TermWidget*>(leaf);
+        panes.append({w, QRect(w->mapTo(this, QPoint(0, 0)), w->size())});
     }
-    if (ix > l.count())
+    m_panes.rebuild(panes);
+}
+
+void TermWidgetHolder::directionalNavigation(NavigationDirection dir) {
+    restoreMaximized();
+    updatePanes();
+
+    // m_currentTerm follows the focus, so there is no need to look for it
+    if (!m_panes.contains(m_currentTerm))
     {
-        l.at(0)->impl()->setFocus(Qt::OtherFocusReason);
+        if (TermWidget *w = static_cast<TermWidget*>(m_panes.first()))
+            w->impl()->setFocus(Qt::OtherFocusReason);
         return;
     }
 
-    // Found an active widget
-    TermWidget *w = l.at(ix);
-    NavigationData from = getNormalizedDimensions(w, dir);
+    if (TermWidget *w = static_cast<TermWidget*>(m_panes.neighbour(m_currentTerm, dir)))
+        w->impl()->setFocus(Qt::OtherFocusReason);
+}
 
-    // Search parent that contains point of interest (right edge middlepoint)
-    QPoint poi = QPoint(from.bottomRight.x(), from.middle.y());
+void TermWidgetHolder::maximizeTerminal(TermWidget *term)
+{
+    if (m_maximized == term)
+        return;
+    restoreMaximized();
 
-    // Perform a search for a TermWidget, where x() is strictly higher than
-    // poi.x(), y() is strictly less than poi.y(), and prioritizing, in order,
-    // lower x(), and lower distance between poi.y() and corners.
+    SplitTree::Node *node = m_tree.node(term);
+    if (node == nullptr || m_tree.count() < 2)
+        return;
 
-    // Only "Right navigation" implementation is necessary -- other cases
-    // are normalized to this one.
+    // The placeholder takes over the geometry of the terminal, so the
+    // siblings are neither moved nor resized. Hiding the splitters does
+    // not resize anything either.
+    QSplitter *parent = static_cast<QSplitter*>(node->parent->object);
+    m_placeholder = new QWidget;
+    parent->replaceWidget(parent->indexOf(term), m_placeholder);
+    static_cast<QWidget*>(m_tree.root()->object)->hide();
+
+    term->setParent(this);
+    static_cast<QGridLayout*>(layout())->addWidget(term, 0, 0);
+    term->show();
+    term->setFocus(Qt::OtherFocusReason);
+    m_maximized = term;
+    m_panes.invalidate();
+}
 
-    l = findChildren<TermWidget*>();
-    int lowestX = INT_MAX;
-    int lowestMidpointDistance = INT_MAX;
-    TermWidget *fittest = nullptr;
-    for (TermWidget * w : std::as_const(l))
-    {
-        NavigationData contenderDims = getNormalizedDimensions(w, dir);
-        int midpointDistance = std::min(
-            abs(poi.y() - contenderDims.topLeft.y()),
-            abs(poi.y() - contenderDims.bottomRight.y())
-        );
-        if (contenderDims.topLeft.x() > poi.x())
-        {
-            if (contenderDims.topLeft.x() > lowestX)
-                continue;
-            if (midpointDistance > lowestMidpointDistance)
-                continue;
-            lowestX = contenderDims.topLeft.x();
-            lowestMidpointDistance = midpointDistance;
-            fittest = w;
-        }
-    }
-    if (fittest != nullptr) {
-        fittest->impl()->setFocus(Qt::OtherFocusReason);
-    }
+void TermWidgetHolder::restoreMaximized()
+{
+    if (m_maximized == nullptr)
+        return;
+
+    TermWidget *term = m_maximized;
+    m_maximized = nullptr;
+    layout()->removeWidget(term);
+    QSplitter *parent = static_cast<QSplitter*>(m_placeholder->parentWidget());
+    parent->replaceWidget(parent->indexOf(m_placeholder), term);
+    delete m_placeholder;
+    m_placeholder = nullptr;
+
+    term->show();
+    static_cast<QWidget*>(m_tree.root()->object)->show();
+    term->setFocus(Qt::OtherFocusReason);
+    m_panes.invalidate();
+}
+
+void TermWidgetHolder::toggleMaximized()
+{
+    if (m_maximized != nullptr)
+        restoreMaximized();
+    else if (m_currentTerm != nullptr)
+        maximizeTerminal(m_currentTerm);
 }
 
 void TermWidgetHolder::clearActiveTerminal()
@@ -280,76 +326,90 @@ void TermWidgetHolder::splitVertical(TermWidget * term)
 
 void TermWidgetHolder::splitCollapse(TermWidget * term)
 {
-    QSplitter * parent = qobject_cast<QSplitter*>(term->parent());
-    assert(parent);
+    restoreMaximized();
+    const SplitTree::Change change = m_tree.remove(term);
+    assert(change.branch);
     term->setParent(nullptr);
     delete term;
+    m_panes.invalidate();
+    emit terminalCountChanged(--m_terminalCount);
 
-    QWidget *nextFocus = Q_NULLPTR;
-
-    // Collapse splitters containing a single element, excluding the top one.
-    if (parent->count() == 1)
-    {
-        QSplitter *uselessSplitterParent = qobject_cast<QSplitter*>(parent->parent());
-        if (uselessSplitterParent != Q_NULLPTR) {
-            int idx = uselessSplitterParent->indexOf(parent);
-            assert(idx != -1);
-            QWidget *singleHeir = parent->widget(0);
-            uselessSplitterParent->insertWidget(idx, singleHeir);
-            if (qobject_cast<TermWidget*>(singleHeir))
-            {
-                nextFocus = singleHeir;
-            }
-            else
-            {
-                nextFocus = singleHeir->findChild<TermWidget*>();
-            }
-            parent->setParent(nullptr);
-            delete parent;
-            // Make sure there's no access to the removed parent
-            parent = uselessSplitterParent;
-        }
-    }
+    // moves the heir of a collapsed branch out of its splitter first
+    QSplitter *parent = syncBranch(change.branch);
+    delete change.dropped;
 
-    if (parent->count() > 0)
+    if (change.focus)
     {
-        if (nextFocus)
-        {
-            nextFocus->setFocus(Qt::OtherFocusReason);
-        }
-        else
-        {
-            parent->widget(0)->setFocus(Qt::OtherFocusReason);
-        }
+        static_cast<TermWidget*>(change.focus)->setFocus(Qt::OtherFocusReason);
         parent->update();
     }
     else
         emit finished();
 }
 
-TermWidget * TermWidgetHolder::split(TermWidget *term, Qt::Orientation orientation, TerminalConfig cfg)
+void TermWidgetHolder::takeTerminal(TermWidget * term)
 {
-    QSplitter *parent = qobject_cast<QSplitter *>(term->parent());
-    assert(parent);
+    if (m_tree.node(term) == nullptr)
+        return;
+    restoreMaximized();
+    const SplitTree::Change change = m_tree.remove(term);
+    assert(change.branch);
+
+    // the pty keeps its size until the terminal is laid out again
+    term->setGeometryHeld(true);
+    term->setBroadcastMember(false);
+    disconnect(term, nullptr, this, nullptr);
+    term->removeEventFilter(this);
+    term->setParent(nullptr);
+    m_panes.invalidate();
+    emit terminalCountChanged(--m_terminalCount);
 
-    int ix = parent->indexOf(term);
-    QList<int> parentSizes = parent->sizes();
+    QSplitter *parent = syncBranch(change.branch);
+    delete change.dropped;
 
-    QList<int> sizes;
-    sizes << 1 << 1;
+    if (change.focus)
+    {
+        if (m_currentTerm == term)
+            m_currentTerm = static_cast<TermWidget*>(change.focus);
+        parent->update();
+    }
+    else
+    {
+        // the terminal is no child anymore and survives the tab
+        m_currentTerm = nullptr;
+        emit finished();
+    }
+}
 
-    QSplitter *s = new QSplitter(orientation, this);
-    s->setFocusPolicy(Qt::NoFocus);
-    s->insertWidget(0, term);
+void TermWidgetHolder::insertTerminal(TermWidget *term, TermWidget *target, Qt::Orientation orientation)
+{
+    restoreMaximized();
+    if (m_tree.node(target) == nullptr)
+        target = m_currentTerm;
+
+    adoptTerm(term);
+    const SplitTree::Change change = m_tree.split(target, orientation, term);
+    assert(change.branch);
+    syncBranch(change.branch);
+    // the terminals of a tab hibernate and wake together
+    if (target->isHibernated())
+        term->hibernate();
+    else
+        term->wake();
+    term->show();
+    term->setGeometryHeld(false);
+    term->setFocus(Qt::OtherFocusReason);
+}
 
-    cfg.provideCurrentDirectory(term->impl()->workingDirectory());
+TermWidget * TermWidgetHolder::split(TermWidget *term, Qt::Orientation orientation, TerminalConfig cfg)
+{
+    restoreMaximized();
+    cfg.provideCurrentDirectory(term->workingDirectory());
 
     TermWidget * w = newTerm(cfg);
-    s->insertWidget(1, w);
-    s->setSizes(sizes);
-
-    parent->insertWidget(ix, s);
-    parent->setSizes(parentSizes);
+    const SplitTree::Change change = m_tree.split(term, orientation, w);
+    assert(change.branch);
+    syncBranch(change.branch);
 
     w->setFocus(Qt::OtherFocusReason);
     return w;
@@ -358,6 +418,12 @@ TermWidget * TermWidgetHolder::split(TermWidget *term, Qt::Orientation orientati
 TermWidget *TermWidgetHolder::newTerm(TerminalConfig &cfg)
 {
     TermWidget *w = new TermWidget(cfg, this);
+    adoptTerm(w);
+    return w;
+}
+
+void TermWidgetHolder::adoptTerm(TermWidget *w)
+{
     // proxy signals
     connect(w, &TermWidget::renameSession, this, &TermWidgetHolder::renameSession);
     connect(w, &TermWidget::removeCurrentSession, this, &TermWidgetHolder::lastTerminalClosed);
@@ -371,8 +437,10 @@ TermWidget *TermWidgetHolder::newTerm(TerminalConfig &cfg)
     connect(w, &TermWidget::splitCollapse, this, &TermWidgetHolder::splitCollapse);
     connect(w, &TermWidget::termGetFocus, this, &TermWidgetHolder::setCurrentTerminal);
     connect(w, &TermWidget::termTitleChanged, this, &TermWidgetHolder::onTermTitleChanged);
+    connect(w, &TermWidget::userInput, this, &TermWidgetHolder::userInput);
+    w->installEventFilter(this);
 
-    return w;
+    emit terminalCountChanged(++m_terminalCount);
 }
 
 void TermWidgetHolder::setCurrentTerminal(TermWidget* term)
@@ -384,6 +452,9 @@ void TermWidgetHolder::setCurrentTerminal(TermWidget* term)
         if (m_currentTerm->impl()->isTitleChanged())
         {
             Q_EMIT termTitleChanged(m_currentTerm->impl()->title(), m_currentTerm->impl()->icon());
+        } else if (!m_currentTerm->config().getTitle().isEmpty())
+        {
+            Q_EMIT termTitleChanged(m_currentTerm->config().getTitle(), QString{});
         } else
         {
             Q_EMIT termTitleChanged(windowTitle(), QString{});
@@ -414,6 +485,10 @@ bool TermWidgetHolder::hasRunningProcess() const
     const QList<TermWidget*> list = findChildren<TermWidget*>();
     for (const auto &term : list)
     {
+        if (term->isPending())
+        {
+            continue;
+        }
         if (auto impl = term->impl())
         {
             if (impl->hasCommand() || impl->getForegroundProcessId() != impl->getShellPID())
@@ -439,10 +514,10 @@ QDBusObjectPath TermWidgetHolder::getActiveTerminal()
 QList<QDBusObjectPath> TermWidgetHolder::getTerminals()
 {
     QList<QDBusObjectPath> terminals;
-    const auto ws = findChildren<TermWidget*>();
-    for (TermWidget* w : ws)
+    const auto leaves = m_tree.leaves();
+    for (QObject *leaf : leaves)
     {
-        terminals.push_back(w->getDbusPath());
+        terminals.push_back(static_cast<TermWidget*>(leaf)->getDbusPath());
     }
     return terminals;
 }
@@ -460,5 +535,32 @@ void TermWidgetHolder::closeTab()
     Q_EMIT parent->tabCloseRequested(idx);
 }
 
+QDBusObjectPath TermWidgetHolder::moveToWindow(const QDBusObjectPath &window, int index)
+{
+    // a new window unless an existing one is given
+    TabWidget *tabs = findParent<TabWidget>(this);
+    MainWindow *target = findDbusObject<MainWindow>(window);
+    if (target == nullptr)
+        target = tabs->moveTabToNewWindow(tabs->tabIndex(this));
+    else
+        tabs->moveTabTo(tabs->tabIndex(this), target->tabWidget(), index);
+    return findParent<MainWindow>(this)->getDbusPath();
+}
+
+QVariantMap TermWidgetHolder::describe()
+{
+    QVariantList terminals;
+    const QList<TermWidget*> terms = this->terminals();
+    for (TermWidget *term : terms)
+        terminals.append(term->describe());
+
+    QVariantMap info;
+    info[QStringLiteral("path")] = QVariant::fromValue(getDbusPath());
+    info[QStringLiteral("activeTerminal")] = QVariant::fromValue(getActiveTerminal());
+    info[QStringLiteral("maximized")] = m_maximized != nullptr;
+    info[QStringLiteral("terminals")] = terminals;
+    return info;
+}
+
 #endif
 
@@ -23,18 +23,11 @@
 #include "termwidget.h"
 #include "terminalconfig.h"
 #include "dbusaddressable.h"
+#include "paneindex.h"
+#include "splittree.h"
 class QSplitter;
 
 
-
-typedef enum NavigationDirection {
-    Left,
-    Right,
-    Top,
-    Bottom
-} NavigationDirection;
-
-
 /*! \brief TermWidget group/session manager.
 
 This widget (one per TabWidget tab) is a "proxy" widget between TabWidget and
@@ -52,13 +45,16 @@ class TermWidgetHolder : public QWidget
 
     public:
         TermWidgetHolder(TerminalConfig &cfg, QWidget * parent=nullptr);
+        // a new tab for a terminal taken from another one
+        TermWidgetHolder(TermWidget * term, QWidget * parent=nullptr);
         ~TermWidgetHolder() override;
 
         void propertiesChanged();
         void setInitialFocus();
 
-        void loadSession();
-        void saveSession(const QString & name);
+        // the split tree with the working directory and command of every terminal
+        QVariant layout() const;
+        bool restoreLayout(const QVariant &layout);
         void zoomIn(uint step);
         void zoomOut(uint step);
 
@@ -67,11 +63,40 @@ class TermWidgetHolder : public QWidget
 
         bool hasRunningProcess() const;
 
+        /*! Shows a single terminal at the size of the whole tab. Only that
+            terminal is moved; the others stay hidden in their splitters at
+            their size until restoreMaximized().
+         */
+        void maximizeTerminal(TermWidget *term);
+        void restoreMaximized();
+        TermWidget *maximizedTerminal() const { return m_maximized; }
+
+        /*! Moving a running terminal to another tab. takeTerminal() leaves
+            it without a parent and with its pty size held; a tab left empty
+            finishes right away. insertTerminal() splits \a target, or the
+            current terminal, to make room for it; the terminal hibernates
+            or wakes up with the others of the tab.
+         */
+        void takeTerminal(TermWidget *term);
+        void insertTerminal(TermWidget *term, TermWidget *target, Qt::Orientation orientation);
+
+    protected:
+        bool eventFilter(QObject *obj, QEvent *event) override;
+        void resizeEvent(QResizeEvent *event) override;
+
+    public:
+        int terminalCount() const { return m_terminalCount; }
+        // in layout order
+        QList<TermWidget*> terminals() const;
+
         #ifdef HAVE_QDBUS
         QDBusObjectPath getActiveTerminal();
         QList<QDBusObjectPath> getTerminals();
         QDBusObjectPath getWindow();
         void closeTab();
+        QDBusObjectPath moveToWindow(const QDBusObjectPath &window, int index);
+        // path and terminals, for QTerminalApp::describeAll()
+        QVariantMap describe();
         #endif
 
 
@@ -82,6 +107,7 @@ class TermWidgetHolder : public QWidget
         void setWDir(const QString & wdir);
         void directionalNavigation(NavigationDirection dir);
         void clearActiveTerminal();
+        void toggleMaximized();
         void onTermTitleChanged(QString title, QString icon) const;
 
     signals:
@@ -90,14 +116,26 @@ class TermWidgetHolder : public QWidget
         void renameSession();
         void termTitleChanged(QString title, QString icon) const;
         void termFocusChanged();
+        void terminalCountChanged(int count);
+        void userInput(TermWidget * term, const QString & text);
 
     private:
         QString m_wdir;
         QString m_shell;
         TermWidget * m_currentTerm;
-
-        void split(TermWidget * term, Qt::Orientation orientation);
+        int m_terminalCount;
+        PaneIndex m_panes;
+        SplitTree m_tree;
+        TermWidget * m_maximized;
+        // keeps the place of the maximized terminal in its splitter
+        QWidget * m_placeholder;
+
+        explicit TermWidgetHolder(QWidget * parent);
         TermWidget * newTerm(TerminalConfig &cfg);
+        void adoptTerm(TermWidget *term);
+        QSplitter * newSplitter(Qt::Orientation orientation);
+        QSplitter * syncBranch(SplitTree::Node *branch);
+        void updatePanes();
 
     private slots:
         void setCurrentTerminal(TermWidget* term);
@@ -18,9 +18,33 @@
 #include "qterminal_test.h"
 
 #include "qterminalutils.h"
+#include "tabregistry.h"
+#include "outputmeter.h"
+#include "paneindex.h"
+#include "splittree.h"
+#include "sessionstore.h"
+#include "inputfeed.h"
+#include "outputtap.h"
+#include "outputmatcher.h"
+#include "historyrows.h"
+#include "signalthrottle.h"
+#ifdef HAVE_QDBUS
+#include "controlprotocol.h"
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QtDBus/QDBusObjectPath>
+#include <QtDBus/QDBusUnixFileDescriptor>
+#endif
 
 #include <QtTest>
 
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <numeric>
+#include <sys/socket.h>
+#include <unistd.h>
+
 // handy shortcut copied from liblxqt
 #ifndef QL1S
 #define QL1S(x) QLatin1String(x)
@@ -50,4 +74,515 @@ void QTerminalTest::testParseCommand()
              QStringList() << QL1S("fpad") << QL1S("-s") << QL1S("PATH/ha ha"));
 }
 
+void QTerminalTest::testFuzzyMatch()
+{
+    QCOMPARE(fuzzy_match(QString(), QL1S("anything")), 0);
+    QCOMPARE(fuzzy_match(QL1S("xyz"), QL1S("vim build.sh")), -1);
+    QCOMPARE(fuzzy_match(QL1S("mvi"), QL1S("vim")), -1);
+    QVERIFY(fuzzy_match(QL1S("VIM"), QL1S("vim")) >= 0);
+
+    // consecutive characters win over scattered ones
+    QVERIFY(fuzzy_match(QL1S("ab"), QL1S("xab")) > fuzzy_match(QL1S("ab"), QL1S("xaxb")));
+    // word starts win over matches inside words
+    QVERIFY(fuzzy_match(QL1S("bu"), QL1S("vim build.sh")) > fuzzy_match(QL1S("bu"), QL1S("abu")));
+    QVERIFY(fuzzy_match(QL1S("sl"), QL1S("~/src/lxqt")) > fuzzy_match(QL1S("sl"), QL1S("~/isle")));
+    QVERIFY(fuzzy_match(QL1S("tw"), QL1S("TermWidget")) > fuzzy_match(QL1S("tw"), QL1S("Tabswitch")));
+}
+
+void QTerminalTest::testTabRegistry()
+{
+    QObject a, b, c;
+    TabRegistry tabs;
+    tabs.insert(0, &a);
+    tabs.insert(1, &b);
+    tabs.insert(1, &c); // a c b
+    QCOMPARE(tabs.count(), 3);
+    QCOMPARE(tabs.indexOf(&a), 0);
+    QCOMPARE(tabs.indexOf(&c), 1);
+    QCOMPARE(tabs.indexOf(&b), 2);
+
+    tabs.entry(1).title = QL1S("c");
+    tabs.move(1, 2); // a b c
+    QCOMPARE(tabs.indexOf(&b), 1);
+    QCOMPARE(tabs.indexOf(&c), 2);
+    QCOMPARE(tabs.entry(2).title, QL1S("c"));
+    QCOMPARE(tabs.holder(2), &c);
+
+    tabs.remove(0); // b c
+    QCOMPARE(tabs.indexOf(&a), -1);
+    QCOMPARE(tabs.indexOf(&b), 0);
+    QCOMPARE(tabs.indexOf(&c), 1);
+    QCOMPARE(tabs.holder(5), nullptr);
+
+    QObject d, e;
+    tabs.insert(2, &d);
+    tabs.insert(3, &e); // b c d e
+    tabs.remove(QList<int>{0, 2}); // c e
+    QCOMPARE(tabs.count(), 2);
+    QCOMPARE(tabs.indexOf(&b), -1);
+    QCOMPARE(tabs.indexOf(&d), -1);
+    QCOMPARE(tabs.indexOf(&c), 0);
+    QCOMPARE(tabs.indexOf(&e), 1);
+}
+
+void QTerminalTest::testOutputMeter()
+{
+    OutputMeter meter;
+    QCOMPARE(meter.msecsSinceOutput(1000), qint64(-1));
+    QVERIFY(meter.sparkline().isEmpty());
+
+    meter.add(60, 1);
+    meter.add(40, 1);
+    meter.sample(1000);
+    QCOMPARE(meter.totalBytes(), qint64(100));
+    QCOMPARE(meter.bytesPerSecond(), 100.0);
+    QCOMPARE(meter.linesPerSecond(), 2.0);
+
+    meter.add(50, 0);
+    meter.sample(1500);
+    QCOMPARE(meter.bytesPerSecond(), 100.0);
+    meter.sample(2500);
+    QCOMPARE(meter.bytesPerSecond(), 0.0);
+    QCOMPARE(meter.msecsSinceOutput(4000), qint64(2500));
+    QCOMPARE(meter.history(), QList<qint64>({100, 50, 0}));
+    QCOMPARE(meter.sparkline(), QString(QChar(u'\u2588')) + QChar(u'\u2584') + QLatin1Char(' '));
+
+    // the ring buffer keeps the latest samples only
+    for (int i = 0; i < OutputMeter::SampleCount; ++i)
+    {
+        meter.add(i, 0);
+        meter.sample(3000 + i * 1000);
+    }
+    const QList<qint64> history = meter.history();
+    QCOMPARE(history.size(), qsizetype(OutputMeter::SampleCount));
+    QCOMPARE(history.first(), qint64(0));
+    QCOMPARE(history.last(), qint64(OutputMeter::SampleCount - 1));
+    QCOMPARE(meter.totalBytes(), qint64(150 + OutputMeter::SampleCount * (OutputMeter::SampleCount - 1) / 2));
+
+    // past the first bytes of a sample, the lines are extrapolated
+    const qint64 lines = meter.totalLines();
+    QVERIFY(meter.countsLines());
+    meter.add(OutputMeter::LineSampleBytes, 64);
+    QVERIFY(!meter.countsLines());
+    meter.add(OutputMeter::LineSampleBytes);
+    meter.sample(3000 + OutputMeter::SampleCount * 1000);
+    QCOMPARE(meter.linesPerSecond(), 128.0);
+    QCOMPARE(meter.totalLines(), lines + 128);
+    QVERIFY(meter.countsLines());
+}
+
+void QTerminalTest::testPaneIndex()
+{
+    // +-------+---+
+    // |   a   |   |
+    // +---+---+ c |
+    // | b | d |   |
+    // +---+---+---+
+    QObject a, b, c, d;
+    PaneIndex index;
+    QVERIFY(!index.isValid());
+    index.rebuild({{&a, QRect(0, 0, 200, 100)},
+                   {&b, QRect(0, 104, 98, 96)},
+                   {&c, QRect(204, 0, 96, 200)},
+                   {&d, QRect(102, 104, 98, 96)}});
+    QVERIFY(index.isValid());
+    QCOMPARE(index.count(), 4);
+
+    QCOMPARE(index.neighbour(&a, Right), &c);
+    QCOMPARE(index.neighbour(&d, Top), &a);
+    QCOMPARE(index.neighbour(&a, Left), nullptr);
+    QCOMPARE(index.neighbour(&a, Top), nullptr);
+    QCOMPARE(index.neighbour(&b, Right), &d);
+    QCOMPARE(index.neighbour(&b, Top), &a);
+    QCOMPARE(index.neighbour(&d, Right), &c);
+    QCOMPARE(index.neighbour(&d, Left), &b);
+    QCOMPARE(index.neighbour(&c, Left), &a);
+
+    index.invalidate();
+    QVERIFY(!index.isValid());
+    QVERIFY(!index.contains(&a));
+    QCOMPARE(index.neighbour(&a, Right), nullptr);
+}
+
+void QTerminalTest::testSplitTree()
+{
+    QObject a, b, c, d;
+    SplitTree tree;
+    tree.append(&a);
+    QCOMPARE(tree.count(), 1);
+
+    // splitting along the orientation of the parent adds a sibling
+    SplitTree::Change change = tree.split(&a, Qt::Vertical, &b);
+    QCOMPARE(change.branch, tree.root());
+    QCOMPARE(tree.root()->orientation, Qt::Vertical);
+    change = tree.split(&b, Qt::Vertical, &c);
+    QCOMPARE(tree.root()->children.size(), 3);
+    QCOMPARE(tree.sizes(tree.root()), QList<int>({5000, 2500, 2500}));
+
+    // and across it a new branch
+    change = tree.split(&c, Qt::Horizontal, &d);
+    QCOMPARE(change.branch, tree.root());
+    SplitTree::Node *branch = tree.node(&d)->parent;
+    QVERIFY(branch != tree.root());
+    QCOMPARE(branch->orientation, Qt::Horizontal);
+    QCOMPARE(branch->ratio, 0.25);
+    QCOMPARE(tree.leaves(), QList<QObject*>({&a, &b, &c, &d}));
+
+    QObject splitter;
+    tree.setObject(branch, &splitter);
+    QCOMPARE(tree.branches(), QList<QObject*>({&splitter}));
+
+    const QVariant layout = tree.toVariant([](QObject *leaf) { return leaf->objectName(); });
+
+    // a branch left with a single child is collapsed
+    change = tree.remove(&c);
+    QCOMPARE(change.branch, tree.root());
+    QCOMPARE(change.dropped, &splitter);
+    QCOMPARE(change.focus, &d);
+    QCOMPARE(tree.node(&d)->parent, tree.root());
+    QCOMPARE(tree.node(&d)->ratio, 0.25);
+    QCOMPARE(tree.count(), 3);
+
+    change = tree.remove(&a);
+    QCOMPARE(change.focus, &b);
+    QCOMPARE(tree.sizes(tree.root()), QList<int>({5000, 5000}));
+
+    // restore the layout saved above
+    QObject e, f, g, h;
+    QList<QObject*> created{&e, &f, &g, &h};
+    QVERIFY(tree.fromVariant(layout, [&created](const QVariant &) { return created.takeFirst(); }));
+    QCOMPARE(tree.leaves(), QList<QObject*>({&e, &f, &g, &h}));
+    QCOMPARE(tree.node(&h)->parent->orientation, Qt::Horizontal);
+    QCOMPARE(tree.node(&a), nullptr);
+    QCOMPARE(tree.branches(), QList<QObject*>());
+
+    QVERIFY(!tree.fromVariant(QVariantMap(), [](const QVariant &) { return nullptr; }));
+    QCOMPARE(tree.count(), 4);
+
+    // validation names the pane that fails
+    QString error;
+    QVERIFY(SplitTree::isValid(layout, true, &error));
+    QVERIFY(error.isEmpty());
+    QVariantMap broken = layout.toMap();
+    QVariantList children = broken.value(QStringLiteral("children")).toList();
+    QVariantMap lone = children.at(2).toMap();
+    lone[QStringLiteral("children")] = lone.value(QStringLiteral("children")).toList().mid(0, 1);
+    children[2] = lone;
+    broken[QStringLiteral("children")] = children;
+    QVERIFY(!SplitTree::isValid(broken, true, &error));
+    QCOMPARE(error, QStringLiteral("pane at children/2: a split needs at least two children"));
+    QVERIFY(!SplitTree::isValid(QVariantMap(), true, &error));
+    QCOMPARE(error, QStringLiteral("the root has no panes"));
+}
+
+void QTerminalTest::testSessionStore()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const SessionStore store(dir.filePath(QStringLiteral("sessions")));
+    QVERIFY(store.names().isEmpty());
+    QVERIFY(store.load(QStringLiteral("missing")).isEmpty());
+
+    QVariantMap terminal;
+    terminal[QStringLiteral("workingDirectory")] = QStringLiteral("/tmp");
+    terminal[QStringLiteral("command")] = QStringList{QStringLiteral("top")};
+    QVariantMap window;
+    window[QStringLiteral("geometry")] = QByteArray("\x01\x02", 2);
+    window[QStringLiteral("tabs")] = QVariantList{terminal};
+    QVariantMap workspace;
+    workspace[QStringLiteral("windows")] = QVariantList{window};
+
+    // any name is fine, even one that looks like a path
+    const QString name = QStringLiteral("../morning/dev");
+    QVERIFY(store.save(name, workspace));
+    QCOMPARE(store.names(), QStringList{name});
+
+    const QVariantMap loaded = store.load(name);
+    const QVariantMap loadedWindow = loaded.value(QStringLiteral("windows")).toList().value(0).toMap();
+    QCOMPARE(loadedWindow.value(QStringLiteral("geometry")).toByteArray(), QByteArray("\x01\x02", 2));
+    const QVariantMap loadedTerminal = loadedWindow.value(QStringLiteral("tabs")).toList().value(0).toMap();
+    QCOMPARE(loadedTerminal.value(QStringLiteral("workingDirectory")).toString(), QStringLiteral("/tmp"));
+    QCOMPARE(loadedTerminal.value(QStringLiteral("command")).toStringList(), QStringList{QStringLiteral("top")});
+
+    // sessions of another format or a newer version are ignored
+    QVERIFY(SessionStore::decode(QByteArray("garbage")).isEmpty());
+    QCborMap future;
+    future[QLatin1String("format")] = QLatin1String("qterminal-session");
+    future[QLatin1String("version")] = SessionStore::Version + 1;
+    future[QLatin1String("workspace")] = QCborMap();
+    QVERIFY(SessionStore::decode(future.toCborValue().toCbor()).isEmpty());
+
+    QVERIFY(store.remove(name));
+    QVERIFY(store.names().isEmpty());
+}
+
+void QTerminalTest::testInputFeed()
+{
+    int fds[2];
+    QVERIFY(::pipe(fds) == 0);
+
+    QString received;
+    int backlogChecks = 0;
+    InputFeed feed(fds[0]);
+    // the program is busy at first, the feed has to wait for it
+    feed.setBacklog([&backlogChecks] { return ++backlogChecks < 3 ? 1 << 20 : 0; });
+    connect(&feed, &InputFeed::text, this, [&received](const QString &text) { received += text; });
+    QSignalSpy finished(&feed, &InputFeed::finished);
+    feed.start();
+
+    // "é" is split between two writes
+    QCOMPARE(::write(fds[1], "caf\xc3", 4), ssize_t(4));
+    QTRY_COMPARE(received, QStringLiteral("caf"));
+    QVERIFY(backlogChecks >= 3);
+    QCOMPARE(::write(fds[1], "\xa9!", 2), ssize_t(2));
+    QTRY_COMPARE(received, QString::fromUtf8("caf\xc3\xa9!"));
+    QCOMPARE(finished.count(), 0);
+
+    ::close(fds[1]);
+    QTRY_COMPARE(finished.count(), 1);
+    QVERIFY(!feed.isOpen());
+
+    // a backlog the size of a few lines already holds the feed back
+    QVERIFY(::pipe(fds) == 0);
+    const int senderCopy = ::dup(fds[0]);
+    int backlog = 2 * InputFeed::HighWater;
+    QList<qsizetype> chunks;
+    InputFeed held(fds[0]);
+    held.setBacklog([&backlog] { return backlog; });
+    connect(&held, &InputFeed::text, this, [&chunks](const QString &text) { chunks.append(text.size()); });
+    held.start();
+    // the flags of the descriptor the sender still has are left alone
+    QCOMPARE(::fcntl(senderCopy, F_GETFL) & O_NONBLOCK, 0);
+
+    const QByteArray data(4 * InputFeed::ChunkSize, 'x');
+    QCOMPARE(::write(fds[1], data.constData(), data.size()), ssize_t(data.size()));
+    QTest::qWait(50);
+    QVERIFY(chunks.isEmpty());
+    backlog = 0;
+    QTRY_COMPARE(std::accumulate(chunks.cbegin(), chunks.cend(), qsizetype(0)), data.size());
+    QVERIFY(std::all_of(chunks.cbegin(), chunks.cend(), [](qsizetype size) { return size <= InputFeed::ChunkSize; }));
+
+    ::close(senderCopy);
+    ::close(fds[1]);
+}
+
+void QTerminalTest::testOutputTap()
+{
+    int fds[2];
+    QVERIFY(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+    // a small socket buffer, so that the ring buffer comes into play
+    const int sendBuffer = 4096;
+    ::setsockopt(fds[0], SOL_SOCKET, SO_SNDBUF, &sendBuffer, sizeof(sendBuffer));
+
+    OutputTap tap(fds[0], true, 64);
+    QSignalSpy closed(&tap, &OutputTap::closed);
+
+    tap.write(QByteArrayLiteral("hello"), 1000);
+    // fill the socket until the tap has to buffer
+    const QByteArray block(1024, 'x');
+    qint64 written = 0;
+    while (tap.buffered() == 0 && written < 16 * 1024 * 1024)
+    {
+        tap.write(block.left(32), 2000);
+        written += 32;
+    }
+    QVERIFY(tap.buffered() > 0);
+    // does not fit any more, dropped instead of blocking
+    tap.write(block, 3000);
+    QCOMPARE(tap.droppedBytes(), qint64(block.size()));
+
+    // read everything, the next chunk reports the loss
+    QByteArray received;
+    char buffer[4096];
+    for (;;)
+    {
+        QCoreApplication::processEvents();
+        const ssize_t count = ::recv(fds[1], buffer, sizeof(buffer), MSG_DONTWAIT);
+        if (count > 0)
+            received.append(buffer, count);
+        else if (tap.buffered() == 0)
+            break;
+    }
+    QVERIFY(received.startsWith("T 1000 5\nhello"));
+    tap.write(QByteArrayLiteral("after"), 4000);
+    const ssize_t count = ::recv(fds[1], buffer, sizeof(buffer), MSG_DONTWAIT);
+    QVERIFY(count > 0);
+    QCOMPARE(QByteArray(buffer, count), QByteArrayLiteral("L 4000 1024\nT 4000 5\nafter"));
+
+    ::close(fds[1]);
+    QTRY_COMPARE(closed.count(), 1);
+    QVERIFY(!tap.isOpen());
+}
+
+void QTerminalTest::testOutputMatcher()
+{
+    OutputMatcher matcher(32);
+    const QRegularExpression prompt(QStringLiteral("^\\$ $"), QRegularExpression::MultilineOption);
+
+    // a colored prompt, with the escape sequences and "é" split between chunks
+    matcher.append("caf\xc3");
+    matcher.append("\xa9\r\n\x1b[1;3");
+    matcher.append("2m$ \x1b[0m\x1b]0;title\x07");
+    QCOMPARE(matcher.text(), QString::fromUtf8("caf\xc3\xa9\n$ "));
+
+    QString matched;
+    QVERIFY(matcher.match(prompt, &matched));
+    QCOMPARE(matched, QStringLiteral("$ "));
+    // consumed up to the end of the match
+    QVERIFY(!matcher.match(prompt));
+    QVERIFY(matcher.text().isEmpty());
+
+    // only the last characters are kept
+    matcher.append(QByteArray(40, 'x') + "done");
+    QCOMPARE(matcher.text().size(), qsizetype(32));
+    QVERIFY(matcher.match(QRegularExpression(QStringLiteral("x+done"))));
+}
+
+void QTerminalTest::testHistoryRows()
+{
+    // a wide character does not start in the last column
+    QCOMPARE(wrap_line(QL1S("abcdefg"), 3), (QList<qsizetype>{0, 3, 6}));
+    QCOMPARE(wrap_line(QString::fromUtf8("ab\xe4\xb8\x80" "c"), 3), (QList<qsizetype>{0, 2}));
+    QCOMPARE(wrap_line(QString(), 3), QList<qsizetype>{0});
+    QCOMPARE(char_width(0x301), 0);
+
+    const QByteArray history = "one\nlong line\n\nlast\n";
+    HistoryRows all(4, 0, 100);
+    // written in pieces, as saveHistory() does
+    all.write(history.left(7));
+    all.write(history.mid(7));
+    QCOMPARE(all.rowCount(), 6);
+    QCOMPARE(all.rows(), (QStringList{QL1S("one"), QL1S("long"), QL1S(" lin"), QL1S("e"), QString(), QL1S("last")}));
+
+    HistoryRows range(4, 2, 2);
+    range.write(history);
+    QCOMPARE(range.rows(), (QStringList{QL1S(" lin"), QL1S("e")}));
+
+    // the screen: the last rows
+    HistoryRows tail(4, -3, 2);
+    tail.write(history);
+    QCOMPARE(tail.rows(), (QStringList{QL1S("e"), QString()}));
+}
+
+void QTerminalTest::testSignalThrottle()
+{
+    SignalThrottle throttle;
+    throttle.setInterval(50);
+    QStringList titles;
+    int bells = 0;
+
+    // the first change goes out at once
+    throttle.post(0, [&titles] { titles.append(QStringLiteral("a")); });
+    QCOMPARE(titles, QStringList{QStringLiteral("a")});
+
+    // a burst ends with its latest state, other kinds are limited separately
+    throttle.post(0, [&titles] { titles.append(QStringLiteral("b")); });
+    throttle.post(0, [&titles] { titles.append(QStringLiteral("c")); });
+    throttle.post(1, [&bells] { ++bells; });
+    QCOMPARE(titles.size(), 1);
+    QCOMPARE(bells, 1);
+    QVERIFY(throttle.isPending(0));
+    QTRY_COMPARE(titles, (QStringList{QStringLiteral("a"), QStringLiteral("c")}));
+    QVERIFY(!throttle.isPending(0));
+
+    // without a limit nothing waits
+    throttle.setInterval(0);
+    throttle.post(0, [&titles] { titles.append(QStringLiteral("d")); });
+    throttle.post(0, [&titles] { titles.append(QStringLiteral("e")); });
+    QCOMPARE(titles.size(), 4);
+}
+
+#ifdef HAVE_QDBUS
+void QTerminalTest::testControlProtocol()
+{
+    // which descriptors a request refers to
+    QCOMPARE(maxFdIndex(QJsonArray{QStringLiteral("a"), 1}), -1);
+    QCOMPARE(maxFdIndex(QJsonArray{QJsonObject{{QStringLiteral("fd"), 1}},
+                                   QJsonObject{{QStringLiteral("x"), QJsonArray{QJsonObject{{QStringLiteral("fd"), 0}}}}}}), 1);
+
+    int pipeFds[2];
+    QVERIFY(::pipe(pipeFds) == 0);
+    QVariant arg;
+    QVERIFY(fromJson(QStringLiteral("/terminals/3"), QMetaType::fromType<QDBusObjectPath>(), {}, arg));
+    QCOMPARE(arg.value<QDBusObjectPath>().path(), QStringLiteral("/terminals/3"));
+    QVERIFY(fromJson(QStringLiteral("aGk="), QMetaType::fromType<QByteArray>(), {}, arg));
+    QCOMPARE(arg.toByteArray(), QByteArrayLiteral("hi"));
+    QVERIFY(!fromJson(QStringLiteral("x"), QMetaType::fromType<int>(), {}, arg));
+    QVERIFY(!fromJson(QJsonObject{{QStringLiteral("fd"), 1}}, QMetaType::fromType<QDBusUnixFileDescriptor>(), {pipeFds[0]}, arg));
+    QVERIFY(fromJson(QJsonObject{{QStringLiteral("fd"), 0}}, QMetaType::fromType<QDBusUnixFileDescriptor>(), {pipeFds[0]}, arg));
+    QVERIFY(arg.value<QDBusUnixFileDescriptor>().isValid());
+
+    QVariantMap result;
+    result[QStringLiteral("window")] = QVariant::fromValue(QDBusObjectPath("/windows/1"));
+    result[QStringLiteral("tabs")] = QVariant::fromValue(QList<QDBusObjectPath>{QDBusObjectPath("/tabs/2")});
+    result[QStringLiteral("data")] = QByteArrayLiteral("hi");
+    result[QStringLiteral("pipe")] = arg;
+    QList<int> outFds;
+    const QJsonObject json = toJson(result, outFds).toObject();
+    QCOMPARE(json.value(QStringLiteral("window")).toString(), QStringLiteral("/windows/1"));
+    QCOMPARE(json.value(QStringLiteral("tabs")).toArray(), QJsonArray{QStringLiteral("/tabs/2")});
+    QCOMPARE(json.value(QStringLiteral("data")).toString(), QStringLiteral("aGk="));
+    QCOMPARE(json.value(QStringLiteral("pipe")).toObject().value(QStringLiteral("fd")).toInt(), 0);
+    QCOMPARE(outFds.size(), 1);
+    ::close(outFds.at(0));
+
+    // a request with a descriptor, then EOF before the reply
+    int fds[2];
+    QVERIFY(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+    ControlChannel channel(fds[0]);
+    QSignalSpy closed(&channel, &ControlChannel::closed);
+    QList<QByteArray> lines;
+    connect(&channel, &ControlChannel::lineReceived, this, [&](const QByteArray &line) {
+        lines.append(line);
+        if (lines.size() < 2)
+            return;
+        // replied later, with the descriptor that came along
+        const QList<int> received = channel.takeFds(1);
+        channel.beginReply();
+        QTimer::singleShot(0, this, [&channel, received] {
+            channel.send(QByteArrayLiteral("done\n"), received);
+            channel.endReply();
+        });
+    });
+
+    const char request[] = "first\nsecond";
+    iovec iov = {const_cast<char*>(request), sizeof(request) - 1};
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int))] = {};
+    msghdr msg = {};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+    cmsghdr *c = CMSG_FIRSTHDR(&msg);
+    c->cmsg_level = SOL_SOCKET;
+    c->cmsg_type = SCM_RIGHTS;
+    c->cmsg_len = CMSG_LEN(sizeof(int));
+    std::memcpy(CMSG_DATA(c), &pipeFds[1], sizeof(int));
+    QVERIFY(::sendmsg(fds[1], &msg, 0) == sizeof(request) - 1);
+    ::shutdown(fds[1], SHUT_WR);
+
+    QTRY_COMPARE(closed.count(), 1);
+    QCOMPARE(lines, (QList<QByteArray>{QByteArrayLiteral("first"), QByteArrayLiteral("second")}));
+
+    char reply[16];
+    iov = {reply, sizeof(reply)};
+    msg.msg_controllen = sizeof(control);
+    const ssize_t count = ::recvmsg(fds[1], &msg, 0);
+    QCOMPARE(QByteArray(reply, count), QByteArrayLiteral("done\n"));
+    c = CMSG_FIRSTHDR(&msg);
+    QVERIFY(c != nullptr && c->cmsg_type == SCM_RIGHTS);
+    int passed;
+    std::memcpy(&passed, CMSG_DATA(c), sizeof(int));
+    // the write end of the pipe made the round trip
+    QVERIFY(::write(passed, "x", 1) == 1);
+    char x;
+    QVERIFY(::read(pipeFds[0], &x, 1) == 1);
+
+    ::close(passed);
+    ::close(fds[1]);
+    ::close(pipeFds[0]);
+    ::close(pipeFds[1]);
+}
+#endif
+
 QTEST_MAIN(QTerminalTest)
@@ -27,6 +27,20 @@ class QTerminalTest : public QObject
     // Each private slot is a test function
 private Q_SLOTS:
     void testParseCommand();
+    void testFuzzyMatch();
+    void testTabRegistry();
+    void testOutputMeter();
+    void testPaneIndex();
+    void testSplitTree();
+    void testSessionStore();
+    void testInputFeed();
+    void testOutputTap();
+    void testOutputMatcher();
+    void testHistoryRows();
+    void testSignalThrottle();
+#ifdef HAVE_QDBUS
+    void testControlProtocol();
+#endif
 };
 
 #endif
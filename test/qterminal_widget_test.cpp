@@ -0,0 +1,204 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by LXQt team                                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include "qterminal_widget_test.h"
+
+#include "mainwindow.h"
+#include "properties.h"
+#include "qterminalapp.h"
+#include "tabwidget.h"
+#include "termwidget.h"
+#include "termwidgetholder.h"
+
+#include <QtTest>
+
+static TerminalConfig testConfig()
+{
+    // a program that stays until its terminal is closed, without a prompt
+    return TerminalConfig(QDir::tempPath(), QStringList{QStringLiteral("cat")});
+}
+
+static const int BENCHMARK_TABS = 500;
+
+static TerminalConfig lazyConfig()
+{
+    // background tabs whose shells never start
+    TerminalConfig cfg = testConfig();
+    cfg.setLazy(true);
+    return cfg;
+}
+
+static void openTabs(TabWidget &tabs, int count)
+{
+    for (int i = 0; i < count; ++i)
+        tabs.addNewTab(lazyConfig());
+}
+
+void QTerminalWidgetTest::testMoveHibernatedTerminal()
+{
+    TabWidget tabs;
+    tabs.resize(800, 600);
+    tabs.show();
+    tabs.addNewTab(testConfig());
+    TermWidgetHolder *source = static_cast<TermWidgetHolder*>(tabs.widget(0));
+    TermWidget *a = source->currentTerminal();
+    TermWidget *b = source->split(a, Qt::Horizontal, testConfig());
+    TermWidget *c = source->split(b, Qt::Vertical, testConfig());
+    const int index = tabs.addNewTab(testConfig());
+    TermWidgetHolder *target = static_cast<TermWidgetHolder*>(tabs.widget(index));
+    QCOMPARE(tabs.currentIndex(), index);
+
+    // like hibernateIdleTabs() for the background tab
+    for (TermWidget *term : source->terminals())
+        term->hibernate();
+    QVERIFY(!b->impl()->updatesEnabled());
+
+    // into a tab that is awake
+    source->takeTerminal(b);
+    target->insertTerminal(b, nullptr, Qt::Horizontal);
+    QVERIFY(!b->isHibernated());
+    QVERIFY(b->impl()->updatesEnabled());
+    QVERIFY(a->isHibernated());
+
+    // into a tab of its own
+    tabs.moveTerminalToNewTab(c, &tabs);
+    QVERIFY(!c->isHibernated());
+    QVERIFY(c->impl()->updatesEnabled());
+    QVERIFY(a->isHibernated());
+
+    // and back into the hibernated tab
+    target->takeTerminal(b);
+    source->insertTerminal(b, a, Qt::Horizontal);
+    QVERIFY(b->isHibernated());
+    QVERIFY(!b->impl()->updatesEnabled());
+}
+
+#ifdef HAVE_QDBUS
+static QVariantMap pane(const QString &id)
+{
+    return QVariantMap{{QStringLiteral("terminal"), QVariantMap{{QStringLiteral("id"), id}}}};
+}
+
+void QTerminalWidgetTest::testLayoutPaneIds()
+{
+    const QVariantMap split{{QStringLiteral("children"), QVariantList{pane(QStringLiteral("a")), pane(QStringLiteral("b"))}}};
+    const QVariantMap window{{QStringLiteral("tabs"), QVariantList{
+        QVariantMap{{QStringLiteral("layout"), pane(QStringLiteral("c"))}},
+        QVariantMap{{QStringLiteral("layout"), split}},
+    }}};
+    QVariantList tabs;
+    QString error;
+    QSet<QString> ids;
+    QVERIFY(MainWindow::layoutTabs(window, tabs, &error, &ids));
+    QCOMPARE(tabs.size(), 2);
+    QCOMPARE(ids, QSet<QString>({QStringLiteral("a"), QStringLiteral("b"), QStringLiteral("c")}));
+
+    // the ids of another window count as well
+    tabs.clear();
+    QVERIFY(!MainWindow::layoutTabs(window, tabs, &error, &ids));
+    QCOMPARE(error, QStringLiteral("tab 0: pane at children/0: duplicate id \"c\""));
+
+    // and those of the same tab
+    const QVariantMap twice{{QStringLiteral("children"), QVariantList{pane(QStringLiteral("a")), pane(QStringLiteral("a"))}}};
+    tabs.clear();
+    QVERIFY(!MainWindow::layoutTabs(QVariantMap{{QStringLiteral("tabs"), QVariantList{QVariantMap{{QStringLiteral("layout"), twice}}}}},
+                                    tabs, &error));
+    QCOMPARE(error, QStringLiteral("tab 0: pane at children/1: duplicate id \"a\""));
+}
+#endif
+
+void QTerminalWidgetTest::benchmarkTabOpen()
+{
+    QBENCHMARK {
+        TabWidget tabs;
+        tabs.resize(800, 600);
+        tabs.show();
+        openTabs(tabs, BENCHMARK_TABS);
+        QCOMPARE(tabs.count(), BENCHMARK_TABS);
+    }
+}
+
+void QTerminalWidgetTest::benchmarkTabClose()
+{
+    TabWidget tabs;
+    tabs.resize(800, 600);
+    tabs.show();
+    openTabs(tabs, BENCHMARK_TABS);
+    // the current tab stays, no other one is shown and starts its shell
+    tabs.setCurrentIndex(BENCHMARK_TABS - 1);
+
+    // from the front, so that every tab after the closed one moves
+    QBENCHMARK_ONCE {
+        while (tabs.count() > 1)
+            tabs.removeTab(0);
+    }
+    QCOMPARE(tabs.count(), 1);
+}
+
+void QTerminalWidgetTest::benchmarkTabMove()
+{
+    TabWidget tabs;
+    tabs.resize(800, 600);
+    tabs.show();
+    openTabs(tabs, BENCHMARK_TABS);
+    QWidget *first = tabs.widget(0);
+
+    QBENCHMARK {
+        // drag the first tab to the end and back
+        for (int i = 0; i < BENCHMARK_TABS - 1; ++i)
+            tabs.tabBar()->moveTab(i, i + 1);
+        for (int i = BENCHMARK_TABS - 1; i > 0; --i)
+            tabs.tabBar()->moveTab(i, i - 1);
+    }
+    QCOMPARE(tabs.tabIndex(first), 0);
+}
+
+void QTerminalWidgetTest::benchmarkTabTitle()
+{
+    TabWidget tabs;
+    tabs.resize(800, 600);
+    tabs.show();
+    openTabs(tabs, BENCHMARK_TABS);
+    QList<TermWidgetHolder*> holders;
+    for (int i = 0; i < tabs.count(); ++i)
+        holders.append(static_cast<TermWidgetHolder*>(tabs.widget(i)));
+
+    // a title that does not change is skipped, so they alternate
+    int round = 0;
+    QBENCHMARK {
+        const QString title = QStringLiteral("user@host:~/%1").arg(++round % 2);
+        for (TermWidgetHolder *holder : std::as_const(holders))
+            emit holder->termTitleChanged(title, QString());
+    }
+    QCOMPARE(tabs.tabText(BENCHMARK_TABS - 1), QStringLiteral("user@host:~/%1").arg(round % 2));
+}
+
+int main(int argc, char *argv[])
+{
+    QApplication::setApplicationName(QStringLiteral("qterminal_widget_test"));
+    // the settings of the user are left alone
+    QStandardPaths::setTestModeEnabled(true);
+    QTerminalApp *app = QTerminalApp::Instance(argc, argv);
+    Properties::Instance()->loadSettings();
+
+    QTerminalWidgetTest test;
+    const int ret = QTest::qExec(&test, argc, argv);
+
+    delete Properties::Instance();
+    app->cleanup();
+    return ret;
+}
@@ -0,0 +1,39 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by LXQt team                                       *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#ifndef QTERMINAL_WIDGET_TEST_H
+#define QTERMINAL_WIDGET_TEST_H
+
+#include <QObject>
+
+// Tests of the widgets, which need the application object and a screen
+class QTerminalWidgetTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testMoveHibernatedTerminal();
+#ifdef HAVE_QDBUS
+    void testLayoutPaneIds();
+#endif
+    void benchmarkTabOpen();
+    void benchmarkTabClose();
+    void benchmarkTabMove();
+    void benchmarkTabTitle();
+};
+
+#endif